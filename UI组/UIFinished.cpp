@@ -10,6 +10,10 @@
 #pragma comment(lib, "winmm.lib")
 #include <math.h>
 
+#include "../rr_asset.h"
+#include "../rr_atlas.h"
+#include "../rr_pixel.h"
+#include "ui_atlas.h"       // rr_atlas_tool 根据 ui_atlas.txt 生成
 
 // --- 全局常量 ---
 #define WIN_WIDTH 800
@@ -112,7 +116,8 @@ DifficultyLevel selectedLevel = LEVEL_NORMAL;
 Dino dino;
 Obstacle obstacles[5];
 Cloud clouds[5];
-IMAGE pixelManImg[3];
+// 三个角色的像素小人 (带 alpha 的 PNG)
+const char* pixelManPaths[3] = {"assets/pixel_man1.png", "assets/pixel_man2.png", "assets/pixel_man3.png"};
 int obstacleCount = 0;
 int score = 0;
 int highScore = 0;
@@ -143,6 +148,105 @@ CharacterConfig charConfigs[CHAR_COUNT] = {
     {CHAR_TANK, "坦克龙", 100, 100, 255, 0.8, 0.9, 1.2, 1}
 };
 
+// --- 图片资源缓存 (rr_asset): 每张图只解码一次，以后每帧直接贴 ---
+#define ASSET_BUDGET (32 * 1024 * 1024)     // 四张整屏背景加起来约 9MB，正常不会触发释放
+#define ASSET_REPORT "asset_report.txt"      // 退出时写出每张图的解码耗时和常驻大小
+
+RRAssetCache assets;
+
+void* loadAssetImage(void* ctx, const char* path, int width, int height, size_t* bytes) {
+    IMAGE* img = new IMAGE();
+    loadimage(img, path, width, height, true);
+    if (img->getwidth() <= 0 || img->getheight() <= 0) {
+        delete img;
+        return NULL;
+    }
+    *bytes = (size_t)img->getwidth() * img->getheight() * sizeof(DWORD);
+    return img;
+}
+
+void releaseAssetImage(void* ctx, void* image) {
+    delete (IMAGE*)image;
+}
+
+// 把 path 缩放到 width x height 的图贴到 (x, y)
+void putAsset(int x, int y, const char* path, int width, int height, DWORD rop = SRCCOPY) {
+    RRAsset* a = rrAssetAcquire(&assets, path, width, height);
+    if (a == NULL) return;
+    putimage(x, y, (IMAGE*)a->image, rop);
+    rrAssetRelease(&assets, a);
+}
+
+// --- 贴图集: 小图和游戏背景拼在几张大图里，画的时候截一块贴出去 ---
+IMAGE* atlasImages[ATLAS_PAGE_COUNT];
+
+// 启动时按 ui_atlas.h 的布局把每张图解码一次，画进对应的页
+void buildAtlas() {
+    for (int p = 0; p < ATLAS_PAGE_COUNT; p++) {
+        atlasImages[p] = new IMAGE(atlasPages[p].width, atlasPages[p].height);
+    }
+    for (int i = 0; i < ATLAS_SPRITE_COUNT; i++) {
+        const RRAtlasSprite* sp = &atlasSprites[i];
+        IMAGE img;
+        loadimage(&img, sp->path, sp->width, sp->height, true);
+        SetWorkingImage(atlasImages[sp->page]);
+        putimage(sp->x, sp->y, &img);
+        SetWorkingImage(NULL);
+    }
+}
+
+void freeAtlas() {
+    for (int p = 0; p < ATLAS_PAGE_COUNT; p++) {
+        delete atlasImages[p];
+        atlasImages[p] = NULL;
+    }
+}
+
+// 把图集里的第 id 张图贴到 (x, y)
+void putSprite(int x, int y, int id, DWORD rop = SRCCOPY) {
+    const RRAtlasSprite* sp = &atlasSprites[id];
+    putimage(x, y, sp->width, sp->height, atlasImages[sp->page], sp->x, sp->y, rop);
+}
+
+// --- 半透明精灵: 载入时转成预乘 alpha，画的时候用 rr_pixel 的内核直接混合进屏幕缓冲 ---
+typedef struct {
+    uint32_t* pixels;       // 0xAARRGGBB (GetImageBuffer 的格式)，预乘 alpha
+    int width, height;
+} AlphaSprite;
+
+AlphaSprite pixelMen[3];
+
+void loadAlphaSprite(AlphaSprite* s, const char* path, int width, int height) {
+    IMAGE img;
+    loadimage(&img, path, width, height, true);
+    s->width = img.getwidth();
+    s->height = img.getheight();
+    s->pixels = (uint32_t*)malloc(sizeof(uint32_t) * s->width * s->height);
+    if (s->pixels == NULL) {
+        s->width = s->height = 0;
+        return;
+    }
+    memcpy(s->pixels, GetImageBuffer(&img), sizeof(uint32_t) * s->width * s->height);
+    rrPremultiply(s->pixels, s->width * s->height);
+}
+
+void freeAlphaSprite(AlphaSprite* s) {
+    free(s->pixels);
+    s->pixels = NULL;
+    s->width = s->height = 0;
+}
+
+// 贴到屏幕 (x, y)，超出窗口的部分裁掉
+void putAlphaSprite(int x, int y, const AlphaSprite* s) {
+    int x0 = (x < 0) ? 0 : x, y0 = (y < 0) ? 0 : y;
+    int x1 = (x + s->width > WIN_WIDTH) ? WIN_WIDTH : x + s->width;
+    int y1 = (y + s->height > WIN_HEIGHT) ? WIN_HEIGHT : y + s->height;
+    if (x0 >= x1 || y0 >= y1) return;
+    uint32_t* screen = (uint32_t*)GetImageBuffer(NULL);
+    rrBlitAlpha(screen + y0 * WIN_WIDTH + x0, WIN_WIDTH, s->pixels + (y0 - y) * s->width + (x0 - x), s->width,
+                x1 - x0, y1 - y0);
+}
+
 // --- 函数声明 ---
 void initGame();
 void handleInput();
@@ -167,7 +271,6 @@ void drawNightSky();
 void drawButton(int x, int y, int width, int height, const char* text, int selected);
 void drawCharPreview(int x, int y, CharacterType type, int selected);
 void drawLevelPreview(int x, int y, DifficultyLevel level, int selected);
-void loadAllCharImages();
 
 // --- 初始化函数 ---
 void initGame() {
@@ -178,13 +281,6 @@ void initGame() {
     dino.width = DINO_WIDTH;
     dino.height = DINO_HEIGHT;
     
-    // 加载三个像素小人图片（从assets目录）
-    const TCHAR* filenames[3] = {_T("assets/pixel_man1.png"), _T("assets/pixel_man2.png"), _T("assets/pixel_man3.png")};
-    
-    // 直接加载图片
-    for (int i = 0; i < 3; i++) {
-        loadimage(&pixelManImg[i], filenames[i], dino.width, dino.height,true);
-    }
     dino.x = 100;
     dino.y = GROUND_Y - DINO_HEIGHT;
     dino.width = DINO_WIDTH;
@@ -346,12 +442,8 @@ void renderGame() {
 
 // --- 绘制主菜单 ---
 void drawMenu() {
-    //定义图片变量 int a;
-    IMAGE img_mm;
-    //加载图片 scanf("%d",&a);
-    loadimage(&img_mm,"assets//mm.jpg",800,700);
-    //输出图片 printf("%d",a);
-    putimage(0,0,&img_mm);
+    // 背景图
+    putAsset(0, 0, "assets//mm.jpg", 800, 700);
     // 绘制标题
     settextcolor(RGB(255, 214, 0));
     settextstyle(60, 0, _T("Abaddon Bold"));
@@ -376,9 +468,7 @@ void drawMenu() {
 // --- 绘制角色选择界面 ---
 void drawCharSelect() {
     // 绘制背景
-    IMAGE img_xx;
-    loadimage(&img_xx,"assets//xx.jpg",800,700);
-    putimage(0,0,&img_xx);
+    putAsset(0, 0, "assets//xx.jpg", 800, 700);
     // 绘制标题 - 居中橙红色宋体
     settextcolor(RGB(255, 100, 50)); // 橙红色
     settextstyle(50, 0, _T("宋体"));
@@ -444,9 +534,7 @@ void drawCharSelect() {
 }
     // --- 绘制难度选择界面 ---
 void drawLevelSelect() {
-   IMAGE img_ss;
-   loadimage(&img_ss,"assets//ss.jpg",800,700);
-   putimage(0,0,&img_ss);
+   putAsset(0, 0, "assets//ss.jpg", 800, 700);
     // 绘制标题
     settextcolor(RGB(255, 100, 50));  // 橙红色
     settextstyle(56, 0, _T("宋体"));
@@ -528,16 +616,12 @@ void drawPlayingState() {
     // 根据主题绘制背景
     GameConfig* config = &levelConfigs[selectedLevel];
     int themeColor = config->themeColor;
-    IMAGE img_2,img_1,img_0;
     if (themeColor == 2) {  // 夜晚
-        loadimage (&img_2,"assets//night.jpg",800,600);
-        putimage(0,0,&img_2);
+        putSprite(0, 0, ATLAS_NIGHT);
     } else if (themeColor == 1) {  // 蓝色主题
-        loadimage (&img_1,"assets//sun.jpg",800,600);
-        putimage(0,0,&img_1);
+        putSprite(0, 0, ATLAS_SUN);
     } else {  // 绿色主题
-        loadimage (&img_0,"assets//green.jpg",800,600);
-        putimage(0,0,&img_0);
+        putSprite(0, 0, ATLAS_GREEN);
     }
     
     // 绘制游戏元素
@@ -550,9 +634,7 @@ void drawPlayingState() {
 
 // --- 绘制游戏结束界面 ---
 void drawGameOver() {
-    IMAGE img_zz;
-    loadimage(&img_zz,"assets//zz.jpg",800,700);
-    putimage(0,0,&img_zz);
+    putAsset(0, 0, "assets//zz.jpg", 800, 700);
 // 游戏结束面板
     setfillcolor(RGB(20, 50, 70));
     int panelWidth = 500;
@@ -622,19 +704,9 @@ void drawButton(int x, int y, int width, int height, const char* text, int selec
     int textHeight = textheight(text);
     outtextxy(x + (width - textWidth) / 2, y + (height - textHeight) / 2, text);
 }
-// 全局IMAGE变量
-IMAGE img_normal, img_speed, img_tank;
-
-// 加载图片
-void loadAllCharImages() {
-    loadimage(&img_normal, "assets//hero.jpg", 120, 140);   // 普通龙=hero.jpg
-    loadimage(&img_speed, "assets//hero2.jpg", 120, 140);  // 速度龙=hero2.jpg
-    loadimage(&img_tank, "assets//hero3.jpg", 120, 140);   // 坦克龙=hero3.jpg
-}
 // --- 绘制角色预览 ---
 void drawCharPreview(int x, int y, CharacterType type, int selected) {
     CharacterConfig* config = &charConfigs[type];
-void loadAllCharImages();
     // 背景框
     if (selected) {
         
@@ -653,13 +725,13 @@ void loadAllCharImages();
     // 核心：绘制jpg格式的小人图（对应type匹配hero/hero2/hero3）
     switch (type) {
     case CHAR_DEFAULT:
-        putimage(x - 60, y - 60, 120, 140, &img_normal, 0, 0);
+        putSprite(x - 60, y - 60, ATLAS_HERO);      // 普通龙=hero.jpg
         break;
     case CHAR_SPEEDY:
-        putimage(x - 60, y - 60, 120, 140, &img_speed, 0, 0);
+        putSprite(x - 60, y - 60, ATLAS_HERO2);     // 速度龙=hero2.jpg
         break;
     case CHAR_TANK:
-        putimage(x - 60, y - 60, 120, 140, &img_tank, 0, 0);
+        putSprite(x - 60, y - 60, ATLAS_HERO3);     // 坦克龙=hero3.jpg
         break;
     }
 
@@ -710,18 +782,14 @@ if (selected) {
     
     // 难度图标
     setfillcolor(RGB(255, 255, 200));
-    IMAGE img_d1,img_d2,img_d3;
     if (level == LEVEL_EASY) {
-        loadimage(&img_d1,"assets//difficulty1.jpg",100,120);
-        putimage(x-50,y-60,&img_d1);
+        putSprite(x - 50, y - 60, ATLAS_DIFFICULTY1);
     } else if (level == LEVEL_NORMAL) {
         // 中等
-        loadimage(&img_d2,"assets//difficulty2.jpg",100,120);
-        putimage(x-50,y-60,&img_d2);
+        putSprite(x - 50, y - 60, ATLAS_DIFFICULTY2);
     } else {
         // 困难
-        loadimage(&img_d3,"assets//difficulty3.jpg",100,120);
-        putimage(x-50,y-60,&img_d3);
+        putSprite(x - 50, y - 60, ATLAS_DIFFICULTY3);
     }
     
     // 难度名称
@@ -740,7 +808,7 @@ void drawDino() {
     }
     
      // 绘制透明像素小人（核心修改部分）
-     putimage(dino.x, drawY, &pixelManImg[dino.type],SRCPAINT);
+     putAlphaSprite(dino.x, drawY, &pixelMen[dino.type]);
     // 绘制生命值
     if (dino.lives > 1) {
         settextcolor(RGB(255, 100, 100));
@@ -1050,8 +1118,13 @@ void RunGame() {
     
     // 设置随机种子
     srand((unsigned int)time(NULL));
-    //加载角色图片
-    loadAllCharImages();
+    // 图片资源缓存
+    RRAssetLoader loader = {loadAssetImage, releaseAssetImage, NULL};
+    rrAssetCacheInit(&assets, &loader, ASSET_BUDGET);
+    buildAtlas();
+    for (int i = 0; i < 3; i++) {
+        loadAlphaSprite(&pixelMen[i], pixelManPaths[i], DINO_WIDTH, DINO_HEIGHT);
+    }
     
     // 游戏主循环
     while (gameState != STATE_EXIT) {
@@ -1071,6 +1144,16 @@ void RunGame() {
         lastTime = GetTickCount();
     }
     
+    FILE* report = fopen(ASSET_REPORT, "w");
+    if (report) {
+        rrAssetReport(&assets, report);
+        fclose(report);
+    }
+    rrAssetCacheFree(&assets);
+    freeAtlas();
+    for (int i = 0; i < 3; i++) {
+        freeAlphaSprite(&pixelMen[i]);
+    }
     EndBatchDraw();
     closegraph();
 }
@@ -0,0 +1,40 @@
+/*
+ * 由 rr_atlas_tool 根据 UI组/ui_atlas.txt 生成，不要手改 (改清单后重新生成)
+ * 9 张图装进 1 页，面积利用率 98.4%；使用前先包含 rr_atlas.h
+ */
+#ifndef UI_ATLAS_H
+#define UI_ATLAS_H
+
+enum {
+    ATLAS_HERO,
+    ATLAS_HERO2,
+    ATLAS_HERO3,
+    ATLAS_DIFFICULTY1,
+    ATLAS_DIFFICULTY2,
+    ATLAS_DIFFICULTY3,
+    ATLAS_GREEN,
+    ATLAS_SUN,
+    ATLAS_NIGHT,
+    ATLAS_SPRITE_COUNT
+};
+
+#define ATLAS_PAGE_COUNT 1
+
+static const RRAtlasPage atlasPages[ATLAS_PAGE_COUNT] = {
+    {800, 1940}
+};
+
+// 名字, 路径, 宽, 高, 页, x, y
+static const RRAtlasSprite atlasSprites[ATLAS_SPRITE_COUNT] = {
+    {"HERO", "assets/hero.jpg", 120, 140, 0, 0, 1800},
+    {"HERO2", "assets/hero2.jpg", 120, 140, 0, 120, 1800},
+    {"HERO3", "assets/hero3.jpg", 120, 140, 0, 240, 1800},
+    {"DIFFICULTY1", "assets/difficulty1.jpg", 100, 120, 0, 360, 1800},
+    {"DIFFICULTY2", "assets/difficulty2.jpg", 100, 120, 0, 460, 1800},
+    {"DIFFICULTY3", "assets/difficulty3.jpg", 100, 120, 0, 560, 1800},
+    {"GREEN", "assets/green.jpg", 800, 600, 0, 0, 0},
+    {"SUN", "assets/sun.jpg", 800, 600, 0, 0, 600},
+    {"NIGHT", "assets/night.jpg", 800, 600, 0, 0, 1200}
+};
+
+#endif
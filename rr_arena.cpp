@@ -0,0 +1,69 @@
+/*
+ * 文件名: rr_arena.cpp
+ * 描述: 帧内存池
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "rr_arena.h"
+
+struct RRArenaChunk {
+    RRArenaChunk* next;
+    size_t size;
+    // 后面跟着数据 (对齐到 8 字节)
+};
+
+#define ALIGN_UP(n) (((n) + 7) & ~(size_t)7)
+#define CHUNK_HEADER ALIGN_UP(sizeof(RRArenaChunk))
+
+void rrArenaInit(RRArena* a, size_t capacity) {
+    memset(a, 0, sizeof(RRArena));
+    a->base = (char*)malloc(capacity);
+    if (a->base != NULL) a->capacity = capacity;
+}
+
+static void freeOverflow(RRArena* a) {
+    while (a->overflow != NULL) {
+        RRArenaChunk* next = a->overflow->next;
+        free(a->overflow);
+        a->overflow = next;
+    }
+    a->overflowBytes = 0;
+}
+
+void rrArenaFree(RRArena* a) {
+    freeOverflow(a);
+    free(a->base);
+    memset(a, 0, sizeof(RRArena));
+}
+
+void* rrArenaAlloc(RRArena* a, size_t size) {
+    size = ALIGN_UP(size);
+    if (a->used + size <= a->capacity) {
+        void* p = a->base + a->used;
+        a->used += size;
+        return p;
+    }
+    RRArenaChunk* chunk = (RRArenaChunk*)malloc(CHUNK_HEADER + size);
+    if (chunk == NULL) return NULL;
+    chunk->next = a->overflow;
+    chunk->size = size;
+    a->overflow = chunk;
+    a->overflowBytes += size;
+    return (char*)chunk + CHUNK_HEADER;
+}
+
+void rrArenaReset(RRArena* a) {
+    size_t total = a->used + a->overflowBytes;
+    if (total > a->peak) a->peak = total;
+    if (a->overflow != NULL) {
+        freeOverflow(a);
+        char* grown = (char*)malloc(total);
+        if (grown != NULL) {
+            free(a->base);
+            a->base = grown;
+            a->capacity = total;
+        }
+    }
+    a->used = 0;
+}
@@ -0,0 +1,30 @@
+/*
+ * 文件名: rr_arena.h
+ * 描述: 帧内存池: 一帧里的临时数据从一整块内存顺序切出来，帧结束时整体归零，不逐个释放
+ *       一块不够时临时 malloc 溢出块 (这一帧里已分配的指针都保持有效)，
+ *       下次归零时把主块扩到这一帧用到的总量，之后的帧就不再溢出
+ */
+#ifndef RR_ARENA_H
+#define RR_ARENA_H
+
+#include <stddef.h>
+
+typedef struct RRArenaChunk RRArenaChunk;
+
+typedef struct {
+    char* base;
+    size_t capacity;
+    size_t used;
+    RRArenaChunk* overflow;     // 本帧的溢出块
+    size_t overflowBytes;
+    size_t peak;                // 统计: 单帧最多用过多少
+} RRArena;
+
+void rrArenaInit(RRArena* a, size_t capacity);
+void rrArenaFree(RRArena* a);
+// 分配 size 字节 (按 8 字节对齐)，内存不足返回 NULL
+void* rrArenaAlloc(RRArena* a, size_t size);
+// 本帧分配的全部作废
+void rrArenaReset(RRArena* a);
+
+#endif
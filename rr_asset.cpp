@@ -0,0 +1,105 @@
+/*
+ * 文件名: rr_asset.cpp
+ * 描述: 图片资源缓存
+ *       资源不多 (几十个)，查找和挑选释放对象都直接线性扫描
+ */
+#include <string.h>
+#include <chrono>
+
+#include "rr_asset.h"
+
+void rrAssetCacheInit(RRAssetCache* c, const RRAssetLoader* loader, size_t budget) {
+    memset(c, 0, sizeof(RRAssetCache));
+    c->loader = *loader;
+    c->budget = budget;
+}
+
+static void unload(RRAssetCache* c, RRAsset* a) {
+    if (a->image == NULL) return;
+    c->loader.release(c->loader.ctx, a->image);
+    a->image = NULL;
+    c->resident -= a->bytes;
+    a->bytes = 0;
+}
+
+void rrAssetCacheFree(RRAssetCache* c) {
+    for (int i = 0; i < c->count; i++) unload(c, &c->assets[i]);
+}
+
+// 超出预算时释放最久没用、没有引用的图片 (keep 是刚解码的那个，不动)
+static void trim(RRAssetCache* c, const RRAsset* keep) {
+    while (c->resident > c->budget) {
+        RRAsset* victim = NULL;
+        for (int i = 0; i < c->count; i++) {
+            RRAsset* a = &c->assets[i];
+            if (a == keep || a->image == NULL || a->refs > 0) continue;
+            if (victim == NULL || a->lastUse < victim->lastUse) victim = a;
+        }
+        if (victim == NULL) return;     // 全都在用，只能先超着
+        unload(c, victim);
+        c->evictions++;
+    }
+}
+
+static RRAsset* find(RRAssetCache* c, const char* path, int width, int height) {
+    for (int i = 0; i < c->count; i++) {
+        RRAsset* a = &c->assets[i];
+        if (a->width == width && a->height == height && strcmp(a->path, path) == 0) return a;
+    }
+    if (c->count == RR_ASSET_MAX || strlen(path) >= RR_ASSET_PATH_MAX) return NULL;
+
+    RRAsset* a = &c->assets[c->count++];
+    memset(a, 0, sizeof(RRAsset));
+    strcpy(a->path, path);
+    a->width = width;
+    a->height = height;
+    return a;
+}
+
+RRAsset* rrAssetAcquire(RRAssetCache* c, const char* path, int width, int height) {
+    RRAsset* a = find(c, path, width, height);
+    if (a == NULL || a->failed) return NULL;
+
+    a->lastUse = ++c->clock;
+    if (a->image != NULL) {
+        a->hits++;
+    } else {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        size_t bytes = 0;
+        a->image = c->loader.load(c->loader.ctx, path, width, height, &bytes);
+        a->decodeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        if (a->image == NULL) {
+            a->failed = 1;
+            return NULL;
+        }
+        a->bytes = bytes;
+        a->loads++;
+        a->totalDecodeMs += a->decodeMs;
+        c->resident += bytes;
+        trim(c, a);
+    }
+    a->refs++;
+    return a;
+}
+
+void rrAssetRelease(RRAssetCache* c, RRAsset* a) {
+    if (a == NULL || a->refs <= 0) return;
+    a->refs--;
+    trim(c, NULL);
+}
+
+void rrAssetReport(const RRAssetCache* c, FILE* out) {
+    fprintf(out, "%-32s %9s %10s %6s %10s %10s %8s\n", "资源", "尺寸", "常驻KB", "解码", "上次毫秒", "总毫秒", "命中");
+    for (int i = 0; i < c->count; i++) {
+        const RRAsset* a = &c->assets[i];
+        char size[32];
+        snprintf(size, sizeof(size), "%dx%d", a->width, a->height);
+        if (a->failed) {
+            fprintf(out, "%-32s %9s %10s\n", a->path, size, "解码失败");
+            continue;
+        }
+        fprintf(out, "%-32s %9s %10.1f %6d %10.2f %10.2f %8d\n", a->path, size, a->bytes / 1024.0,
+                a->loads, a->decodeMs, a->totalDecodeMs, a->hits);
+    }
+    fprintf(out, "常驻 %.1f / %.1f MB, 释放 %d 次\n", c->resident / 1048576.0, c->budget / 1048576.0, c->evictions);
+}
@@ -0,0 +1,64 @@
+/*
+ * 文件名: rr_asset.h
+ * 描述: 图片资源缓存: 按 (路径, 目标尺寸) 缓存解码后的图片，第一次用到时解码，之后直接给出同一份
+ *       取用时引用计数加一，用完减一；没人引用的图片留在缓存里，
+ *       常驻内存超过预算时从最久没用过的开始释放 (正在引用的不会释放)
+ *       解码由调用方提供 (EasyX 的 loadimage 等)，这里只管缓存，不依赖图形库
+ *       每个资源记录解码耗时、常驻大小和命中次数，可以输出报告
+ */
+#ifndef RR_ASSET_H
+#define RR_ASSET_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#define RR_ASSET_MAX 64             // 最多这么多个不同的 (路径, 尺寸)
+#define RR_ASSET_PATH_MAX 260
+
+// --- 解码器 ---
+typedef struct {
+    // 解码 path 并缩放到 width x height (0 = 原尺寸)，返回图片，*bytes 填常驻字节数；失败返回 NULL
+    void* (*load)(void* ctx, const char* path, int width, int height, size_t* bytes);
+    void (*release)(void* ctx, void* image);
+    void* ctx;
+} RRAssetLoader;
+
+// --- 一个资源 (句柄就是它的指针，缓存释放前一直有效) ---
+typedef struct {
+    char path[RR_ASSET_PATH_MAX];
+    int width, height;
+    void* image;                    // 解码结果，NULL = 还没解码 / 已被释放 / 解码失败
+    size_t bytes;
+    int refs;
+    int failed;                     // 解码失败过，不再重试
+    unsigned long long lastUse;     // 最后一次取用的序号 (LRU)
+
+    // 统计
+    int loads;                      // 解码次数 (释放后再用会重新解码)
+    int hits;                       // 直接命中的次数
+    double decodeMs;                // 最近一次解码耗时
+    double totalDecodeMs;
+} RRAsset;
+
+typedef struct {
+    RRAssetLoader loader;
+    RRAsset assets[RR_ASSET_MAX];
+    int count;
+    size_t budget;                  // 常驻内存预算 (字节)
+    size_t resident;
+    unsigned long long clock;
+    int evictions;
+} RRAssetCache;
+
+void rrAssetCacheInit(RRAssetCache* c, const RRAssetLoader* loader, size_t budget);
+// 释放全部图片 (不管引用计数)
+void rrAssetCacheFree(RRAssetCache* c);
+
+// 取得 (path, width, height) 的图片并加一次引用；解码失败或缓存已满返回 NULL
+RRAsset* rrAssetAcquire(RRAssetCache* c, const char* path, int width, int height);
+void rrAssetRelease(RRAssetCache* c, RRAsset* a);
+
+// 每个资源一行: 尺寸、常驻大小、解码次数和耗时、命中次数
+void rrAssetReport(const RRAssetCache* c, FILE* out);
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ * 文件名: rr_atlas.cpp
+ * 描述: 贴图集装箱 (skyline 最低优先)
+ *       每页的天际线是一串水平线段 (x, y, 宽)，从左到右铺满页宽；
+ *       放一张图 = 找一段起点，使它往右 w 宽内的最高点最低，然后把这一段抬高到 y + h
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "rr_atlas.h"
+
+#define MAX_SEGMENTS 256
+
+typedef struct {
+    int x, y, width;
+} Segment;
+
+typedef struct {
+    Segment seg[MAX_SEGMENTS];
+    int count;
+    int width, height;
+    int usedWidth, usedHeight;
+} Skyline;
+
+static void skylineInit(Skyline* s, int width, int height) {
+    s->seg[0].x = 0;
+    s->seg[0].y = 0;
+    s->seg[0].width = width;
+    s->count = 1;
+    s->width = width;
+    s->height = height;
+    s->usedWidth = s->usedHeight = 0;
+}
+
+// 从第 i 段起放宽 w 的图，返回底边 y，放不下返回 -1
+static int fitAt(const Skyline* s, int i, int w, int h) {
+    int x = s->seg[i].x;
+    if (x + w > s->width) return -1;
+    int y = 0, left = w;
+    while (left > 0) {
+        if (i >= s->count) return -1;
+        if (s->seg[i].y > y) y = s->seg[i].y;
+        left -= s->seg[i].width;
+        i++;
+    }
+    return (y + h <= s->height) ? y : -1;
+}
+
+// 在 (x, y) 放下 w x h: 插入新段，把被盖住的段截短或删掉
+static int place(Skyline* s, int index, int x, int y, int w, int h) {
+    if (s->count == MAX_SEGMENTS) return 0;
+    memmove(&s->seg[index + 1], &s->seg[index], sizeof(Segment) * (s->count - index));
+    s->seg[index].x = x;
+    s->seg[index].y = y + h;
+    s->seg[index].width = w;
+    s->count++;
+
+    int right = x + w;
+    for (int i = index + 1; i < s->count;) {
+        Segment* g = &s->seg[i];
+        if (g->x >= right) break;
+        int cut = right - g->x;
+        if (cut < g->width) {
+            g->x += cut;
+            g->width -= cut;
+            break;
+        }
+        memmove(&s->seg[i], &s->seg[i + 1], sizeof(Segment) * (s->count - i - 1));
+        s->count--;
+    }
+    // 同样高的相邻段合并
+    for (int i = 0; i + 1 < s->count;) {
+        if (s->seg[i].y == s->seg[i + 1].y) {
+            s->seg[i].width += s->seg[i + 1].width;
+            memmove(&s->seg[i + 1], &s->seg[i + 2], sizeof(Segment) * (s->count - i - 2));
+            s->count--;
+        } else {
+            i++;
+        }
+    }
+    if (x + w > s->usedWidth) s->usedWidth = x + w;
+    if (y + h > s->usedHeight) s->usedHeight = y + h;
+    return 1;
+}
+
+static int tryPlace(Skyline* s, int w, int h, int* outX, int* outY) {
+    int best = -1, bestX = 0, bestY = 0;
+    for (int i = 0; i < s->count; i++) {
+        int y = fitAt(s, i, w, h);
+        if (y < 0) continue;
+        if (best < 0 || y < bestY || (y == bestY && s->seg[i].x < bestX)) {
+            best = i;
+            bestX = s->seg[i].x;
+            bestY = y;
+        }
+    }
+    if (best < 0 || !place(s, best, bestX, bestY, w, h)) return 0;
+    *outX = bestX;
+    *outY = bestY;
+    return 1;
+}
+
+// 高的先放，一样高时宽的先放
+static const RRAtlasSprite* sortBase;
+
+static int compareSize(const void* a, const void* b) {
+    const RRAtlasSprite* x = &sortBase[*(const int*)a];
+    const RRAtlasSprite* y = &sortBase[*(const int*)b];
+    if (x->height != y->height) return y->height - x->height;
+    if (x->width != y->width) return y->width - x->width;
+    return *(const int*)a - *(const int*)b;
+}
+
+int rrAtlasPack(RRAtlasSprite* sprites, int count, int maxWidth, int maxHeight, int padding,
+                RRAtlasPage* pages, int maxPages) {
+    if (maxPages > RR_ATLAS_MAX_PAGES) maxPages = RR_ATLAS_MAX_PAGES;
+    int* order = (int*)malloc(sizeof(int) * (count > 0 ? count : 1));
+    Skyline* lines = (Skyline*)malloc(sizeof(Skyline) * RR_ATLAS_MAX_PAGES);
+    if (order == NULL || lines == NULL) {
+        free(order);
+        free(lines);
+        return -1;
+    }
+    for (int i = 0; i < count; i++) order[i] = i;
+    sortBase = sprites;
+    qsort(order, count, sizeof(int), compareSize);
+
+    // 每张图右边和下边留 padding，页的右下边界也算进去
+    int pageCount = 0;
+    int result = 0;
+    for (int k = 0; k < count && result == 0; k++) {
+        RRAtlasSprite* sp = &sprites[order[k]];
+        int w = sp->width + padding, h = sp->height + padding;
+        int placed = 0;
+        for (int p = 0; p < pageCount && !placed; p++) {
+            if (tryPlace(&lines[p], w, h, &sp->x, &sp->y)) {
+                sp->page = p;
+                placed = 1;
+            }
+        }
+        if (!placed) {
+            if (pageCount == maxPages) {
+                result = -1;
+                break;
+            }
+            skylineInit(&lines[pageCount], maxWidth + padding, maxHeight + padding);
+            if (!tryPlace(&lines[pageCount], w, h, &sp->x, &sp->y)) {
+                result = -1;
+                break;
+            }
+            sp->page = pageCount++;
+        }
+    }
+
+    if (result == 0) {
+        for (int p = 0; p < pageCount; p++) {
+            pages[p].width = lines[p].usedWidth - padding;
+            pages[p].height = lines[p].usedHeight - padding;
+        }
+        result = pageCount;
+    }
+    free(order);
+    free(lines);
+    return result;
+}
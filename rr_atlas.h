@@ -0,0 +1,29 @@
+/*
+ * 文件名: rr_atlas.h
+ * 描述: 贴图集 (atlas): 把许多小图按目标尺寸装进一张或几张大图里，画的时候从大图里截一块贴出去
+ *       装箱用 skyline 最低优先: 按高度从大到小，每张图放到能放下的最低位置 (同样低时靠左)
+ *       布局由 rr_atlas_tool 离线算好，生成头文件 (每张图在第几页、左上角坐标)；
+ *       运行时按头文件把各张图画进页里一次，之后只剩这几页常驻
+ */
+#ifndef RR_ATLAS_H
+#define RR_ATLAS_H
+
+#define RR_ATLAS_MAX_PAGES 8
+
+typedef struct {
+    const char* name;       // 生成头文件里的枚举名
+    const char* path;
+    int width, height;      // 在图集里的尺寸 (加载时缩放到这个尺寸)
+    int page, x, y;         // 装箱结果
+} RRAtlasSprite;
+
+typedef struct {
+    int width, height;      // 实际用到的范围
+} RRAtlasPage;
+
+// 装箱: 每页不超过 maxWidth x maxHeight，图之间留 padding 像素
+// 成功返回页数，有图比一页还大或页数超过 maxPages 返回 -1
+int rrAtlasPack(RRAtlasSprite* sprites, int count, int maxWidth, int maxHeight, int padding,
+                RRAtlasPage* pages, int maxPages);
+
+#endif
@@ -0,0 +1,170 @@
+/*
+ * 文件名: rr_atlas_tool.cpp
+ * 描述: 贴图集离线装箱工具: 读清单 (每行 "名字 路径 宽 高"，# 开头是注释)，
+ *       在不超过最大页尺寸的前提下试遍页宽 (16 像素一档)，取总页面积最小的装法，
+ *       生成头文件: 每张图的枚举、所在页和坐标，以及每页的尺寸
+ *       尺寸写的是游戏里加载时缩放到的尺寸，所以不用解码图片就能装箱；
+ *       页里的像素由游戏启动时按头文件拼出来 (见 UI组/UIFinished.cpp 的 buildAtlas)
+ * 编译: g++ -O2 -std=c++11 rr_atlas_tool.cpp rr_atlas.cpp -o rr_atlas_tool
+ * 用法: rr_atlas_tool <清单> <输出头文件> [最大页尺寸=2048] [间隔=0]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rr_atlas.h"
+
+#define MAX_SPRITES 256
+#define NAME_MAX_LEN 64
+#define PATH_MAX_LEN 260
+
+typedef struct {
+    char name[NAME_MAX_LEN];
+    char path[PATH_MAX_LEN];
+} Entry;
+
+static Entry entries[MAX_SPRITES];
+static RRAtlasSprite sprites[MAX_SPRITES];
+
+static int readManifest(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        printf("无法打开清单 %s\n", path);
+        return -1;
+    }
+    char line[512];
+    int count = 0, lineNo = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineNo++;
+        char* p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '#' || *p == '\n' || *p == '\r' || *p == 0) continue;
+        if (count == MAX_SPRITES) {
+            printf("清单超过 %d 项\n", MAX_SPRITES);
+            count = -1;
+            break;
+        }
+        Entry* e = &entries[count];
+        RRAtlasSprite* s = &sprites[count];
+        if (sscanf(p, "%63s %259s %d %d", e->name, e->path, &s->width, &s->height) != 4 ||
+            s->width <= 0 || s->height <= 0) {
+            printf("%s:%d: 格式应为 \"名字 路径 宽 高\"\n", path, lineNo);
+            count = -1;
+            break;
+        }
+        s->name = e->name;
+        s->path = e->path;
+        count++;
+    }
+    fclose(f);
+    return count;
+}
+
+// 生成的头文件里用的保护宏: 文件名大写，非字母数字换成下划线
+static void guardName(const char* path, char* out, int size) {
+    const char* base = path;
+    for (const char* p = path; *p; p++) {
+        if (*p == '/' || *p == '\\') base = p + 1;
+    }
+    int n = 0;
+    for (const char* p = base; *p && n < size - 1; p++) {
+        char c = *p;
+        if (c >= 'a' && c <= 'z') c = (char)(c - 'a' + 'A');
+        else if (!((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))) c = '_';
+        out[n++] = c;
+    }
+    out[n] = 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        printf("用法: rr_atlas_tool <清单> <输出头文件> [最大页尺寸] [间隔]\n");
+        return 1;
+    }
+    const char* manifest = argv[1];
+    const char* output = argv[2];
+    int maxSize = (argc > 3) ? atoi(argv[3]) : 2048;
+    int padding = (argc > 4) ? atoi(argv[4]) : 0;
+    if (maxSize <= 0 || padding < 0) {
+        printf("用法: rr_atlas_tool <清单> <输出头文件> [最大页尺寸] [间隔]\n");
+        return 1;
+    }
+
+    int count = readManifest(manifest);
+    if (count <= 0) {
+        if (count == 0) printf("清单是空的\n");
+        return 1;
+    }
+
+    // 试遍页宽，取总面积最小 (一样时页数少) 的装法
+    static RRAtlasSprite trial[MAX_SPRITES];
+    RRAtlasPage pages[RR_ATLAS_MAX_PAGES], trialPages[RR_ATLAS_MAX_PAGES];
+    int bestPages = -1, bestWidth = 0;
+    long long bestArea = 0;
+    for (int width = 16; width <= maxSize + 15; width += 16) {
+        int w = (width > maxSize) ? maxSize : width;
+        memcpy(trial, sprites, sizeof(RRAtlasSprite) * count);
+        int n = rrAtlasPack(trial, count, w, maxSize, padding, trialPages, RR_ATLAS_MAX_PAGES);
+        if (n <= 0) continue;
+        long long area = 0;
+        for (int p = 0; p < n; p++) area += (long long)trialPages[p].width * trialPages[p].height;
+        if (bestPages < 0 || area < bestArea || (area == bestArea && n < bestPages)) {
+            bestPages = n;
+            bestArea = area;
+            bestWidth = w;
+            memcpy(pages, trialPages, sizeof(RRAtlasPage) * n);
+            for (int i = 0; i < count; i++) {
+                sprites[i].page = trial[i].page;
+                sprites[i].x = trial[i].x;
+                sprites[i].y = trial[i].y;
+            }
+        }
+    }
+    if (bestPages < 0) {
+        printf("装不下: 有图大于 %d x %d，或需要超过 %d 页\n", maxSize, maxSize, RR_ATLAS_MAX_PAGES);
+        return 2;
+    }
+
+    long long used = 0;
+    for (int i = 0; i < count; i++) used += (long long)sprites[i].width * sprites[i].height;
+
+    FILE* f = fopen(output, "w");
+    if (!f) {
+        printf("无法写入 %s\n", output);
+        return 1;
+    }
+    char guard[128];
+    guardName(output, guard, sizeof(guard));
+    fprintf(f, "/*\n");
+    fprintf(f, " * 由 rr_atlas_tool 根据 %s 生成，不要手改 (改清单后重新生成)\n", manifest);
+    fprintf(f, " * %d 张图装进 %d 页，面积利用率 %.1f%%；使用前先包含 rr_atlas.h\n", count, bestPages,
+            100.0 * used / bestArea);
+    fprintf(f, " */\n");
+    fprintf(f, "#ifndef %s\n#define %s\n\n", guard, guard);
+    fprintf(f, "enum {\n");
+    for (int i = 0; i < count; i++) fprintf(f, "    ATLAS_%s,\n", entries[i].name);
+    fprintf(f, "    ATLAS_SPRITE_COUNT\n};\n\n");
+    fprintf(f, "#define ATLAS_PAGE_COUNT %d\n\n", bestPages);
+    fprintf(f, "static const RRAtlasPage atlasPages[ATLAS_PAGE_COUNT] = {\n");
+    for (int p = 0; p < bestPages; p++) {
+        fprintf(f, "    {%d, %d}%s\n", pages[p].width, pages[p].height, (p + 1 < bestPages) ? "," : "");
+    }
+    fprintf(f, "};\n\n");
+    fprintf(f, "// 名字, 路径, 宽, 高, 页, x, y\n");
+    fprintf(f, "static const RRAtlasSprite atlasSprites[ATLAS_SPRITE_COUNT] = {\n");
+    for (int i = 0; i < count; i++) {
+        const RRAtlasSprite* s = &sprites[i];
+        fprintf(f, "    {\"%s\", \"%s\", %d, %d, %d, %d, %d}%s\n", entries[i].name, entries[i].path,
+                s->width, s->height, s->page, s->x, s->y, (i + 1 < count) ? "," : "");
+    }
+    fprintf(f, "};\n\n#endif\n");
+    if (fclose(f) != 0) {
+        printf("写入 %s 失败\n", output);
+        return 1;
+    }
+
+    printf("%d 张图 -> %d 页 (页宽上限 %d):", count, bestPages, bestWidth);
+    for (int p = 0; p < bestPages; p++) printf(" %dx%d", pages[p].width, pages[p].height);
+    printf("，利用率 %.1f%%\n", 100.0 * used / bestArea);
+    return 0;
+}
@@ -0,0 +1,409 @@
+/*
+ * 文件名: rr_balance.cpp
+ * 描述: 平衡性蒙特卡洛模拟器 (无界面，Linux / Windows 命令行均可)
+ *       对每个 角色 x 难度 组合用脚本策略跑大量局，统计存活曲线、分数分布和死因
+ *       脚本按当前速度和角色的滞空步数算起跳距离 (让跳跃的最高点对准障碍物)，
+ *       每局抽一个反应误差范围，每个障碍物再在范围内抽一次早晚，模拟不同水平的玩家
+ *       批量模式 (通道数 > 0) 每个线程同步推进多局，碰撞粗测用 rrCollideLanes 一次测完所有局；
+ *       每局的种子和步骤不变，结果与逐局模式完全相同
+ * 编译: g++ -O2 -std=c++11 -pthread rr_balance.cpp rr_core.cpp rr_collide.cpp -o rr_balance
+ * 用法: rr_balance [每组局数=100000] [线程数=CPU核数] [每局最大步数=36000] [种子=1] [通道数=0 逐局]
+ */
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "rr_collide.h"
+#include "rr_core.h"
+
+// --- 统计参数 ---
+#define COMBO_COUNT (CHAR_COUNT * LEVEL_COUNT)
+#define SURVIVAL_BINS 20        // 存活曲线采样点数
+#define SCORE_STEP 10           // 每过一个障碍物加的分，分数按它逐格计数 (分位数是准确值)
+#define SCORE_ROWS 40           // 打印直方图时合并成这么多行
+#define CAUSE_COUNT 4           // 0/1/2 = 障碍物类型, 3 = 跑满步数
+#define RUNS_PER_CHUNK 256      // 每次领取的任务大小
+#define MAX_SPREAD 2            // 反应误差范围最大 (步)，每局在 0..MAX_SPREAD 里抽 (再大几乎每局撞第一个)
+#define HOVER_AIR_TICKS 30      // 不会落地的轨迹 (悬停) 按这么多步滞空算
+#define MAX_LANES 1024          // 批量模式的通道数上限
+
+const char* causeNames[CAUSE_COUNT] = {"小仙人掌", "大仙人掌", "飞鸟", "跑满步数"};
+
+// --- 脚本策略的每局状态 ---
+typedef struct {
+    RRRng rng;              // 由局种子派生，结果与线程数无关
+    int spread;             // 这一局的反应误差范围 (步)
+    int jitter;             // 对当前障碍物的误差 (步，正 = 早按)
+    int lastX;              // 上一步最近障碍物的 x，变大说明换了一个，重新抽误差
+} Policy;
+
+// --- 单个组合的统计 ---
+typedef struct {
+    long long runs;
+    long long deathsInBin[SURVIVAL_BINS];   // 在第几段死亡
+    long long* scoreCounts;                 // [scoreSlots]，第 i 格 = 得分 i * SCORE_STEP 的局数
+    long long causes[CAUSE_COUNT];
+    long long scoreSum;
+    long long stepSum;
+} ComboStats;
+
+typedef struct {
+    ComboStats combos[COMBO_COUNT];
+} ThreadStats;
+
+// --- 运行参数 (所有线程只读) ---
+int runsPerCombo = 100000;
+int threadCount = 0;
+int maxSteps = 36000;        // 60步/秒 下 10 分钟
+unsigned int baseSeed = 1;
+int scoreSlots = 0;          // 分数格数，由 maxSteps 算出 (main)
+int laneCount = 0;           // > 0: 批量模式，每个线程同步推进这么多局
+
+std::atomic<long long> nextChunk(0);
+
+// --- 脚本策略: 看最近的障碍物决定跳/蹲 ---
+void policyInit(Policy* p, unsigned int seed) {
+    rrRngSeed(&p->rng, seed, RR_STREAM_POLICY);
+    p->spread = rrRngRange(&p->rng, MAX_SPREAD + 1);
+    p->jitter = 0;
+    p->lastX = -1;
+}
+
+void choosePolicyInput(const RRWorld* w, Policy* p, RRInput* in) {
+    const Dino* dino = &w->dino;
+    const RRObstaclePool* obs = &w->obstacles;
+    int nearest = -1;
+
+    for (int i = 0; i < obs->count; i++) {
+        if (obs->x[i] + obs->width[i] < dino->x) continue;
+        if (nearest < 0 || obs->x[i] < obs->x[nearest]) nearest = i;
+    }
+
+    in->jump = 0;
+    in->duck = 0;
+    if (nearest < 0) {
+        p->lastX = -1;
+        return;
+    }
+    if (obs->x[nearest] > p->lastX) {
+        p->jitter = rrRngRange(&p->rng, 2 * p->spread + 1) - p->spread;
+    }
+    p->lastX = obs->x[nearest];
+
+    int gap = obs->x[nearest] - (dino->x + dino->width);
+    int bottom = obs->y[nearest] + obs->height[nearest];
+    int standTop = GROUND_Y - DINO_HEIGHT;
+    int duckTop = GROUND_Y - (DINO_HEIGHT - 20);
+
+    if (obs->type[nearest] == 2 && bottom <= standTop) {
+        return;                              // 飞得高，直接走过去
+    }
+    if (obs->type[nearest] == 2 && bottom <= duckTop) {
+        in->duck = (gap <= w->gameSpeed * (2 + p->jitter)); // 蹲下能躲过
+        return;
+    }
+
+    // 滞空一半的时候恐龙正好在障碍物正上方: 起跳距离随速度变
+    const RRJumpTrack* track = rrJumpTrack(w->charType, w->gravityLevel);
+    int air = (track->landing == RR_JUMP_HOVER) ? HOVER_AIR_TICKS : track->landing;
+    int lead = w->gameSpeed * (air + 2 * p->jitter) / 2 - (obs->width[nearest] + dino->width) / 2;
+    if (gap <= lead) {
+        in->jump = 1;
+    }
+}
+
+// --- 一局的结果记入统计 ---
+void recordRun(ComboStats* stats, const RRWorld* world) {
+    int cause = world->gameOver ? world->deathCause : CAUSE_COUNT - 1;
+    stats->runs++;
+    stats->causes[cause]++;
+    stats->scoreSum += world->score;
+    stats->stepSum += world->frameCount;
+
+    if (world->gameOver) {
+        int bin = (int)((long long)world->frameCount * SURVIVAL_BINS / maxSteps);
+        if (bin >= SURVIVAL_BINS) bin = SURVIVAL_BINS - 1;
+        stats->deathsInBin[bin]++;
+    }
+
+    int slot = world->score / SCORE_STEP;
+    if (slot >= scoreSlots) slot = scoreSlots - 1;
+    stats->scoreCounts[slot]++;
+}
+
+// 种子只由组合和局号决定，结果与线程数、通道数无关
+unsigned int runSeed(int combo, int run) {
+    return baseSeed + (unsigned int)(combo * runsPerCombo + run) * 2654435761u;
+}
+
+// --- 跑一局，结果记入统计 ---
+void runOne(ComboStats* stats, CharacterType ch, DifficultyLevel lv, unsigned int seed) {
+    RRWorld world;
+    RRInput input;
+    Policy policy;
+
+    rrInitWorld(&world, ch, lv, seed);
+    policyInit(&policy, seed);
+    while (!world.gameOver && world.frameCount < maxSteps) {
+        choosePolicyInput(&world, &policy, &input);
+        rrStep(&world, &input);
+    }
+    recordRun(stats, &world);
+}
+
+// --- 批量模式: 每个通道一局，同步推进 ---
+// 每步各局先 rrStepMove，再按 "各局的第 k 个障碍物" 转置成列，用 rrCollideLanes 一次测完
+// 所有通道；粗测没碰到任何障碍物的局直接跳过碰撞，其余的照常做精确的扫掠检测
+// 一局结束就在同一个通道上开下一局
+typedef struct {
+    std::vector<RRWorld> worlds;
+    std::vector<Policy> policies;
+    std::vector<RRStepSweep> sweeps;
+    std::vector<int> runs;                  // 通道上的局号，-1 = 空闲
+    std::vector<int> dinoX, dinoY, dinoWidth, dinoHeight;  // 各通道的粗测盒
+    std::vector<int> obsX, obsY, obsWidth, obsHeight;      // 各通道的第 k 个障碍物
+    std::vector<uint32_t> hits, mask;
+} Lanes;
+
+void lanesInit(Lanes* l) {
+    l->worlds.resize(laneCount);
+    l->policies.resize(laneCount);
+    l->sweeps.resize(laneCount);
+    l->runs.assign(laneCount, -1);
+    l->dinoX.assign(laneCount, 0);
+    l->dinoY.assign(laneCount, 0);
+    l->dinoWidth.assign(laneCount, 0);
+    l->dinoHeight.assign(laneCount, 0);
+    l->obsX.resize(laneCount);
+    l->obsY.resize(laneCount);
+    l->obsWidth.resize(laneCount);
+    l->obsHeight.resize(laneCount);
+    l->hits.resize(RR_MASK_WORDS(laneCount));
+    l->mask.resize(RR_MASK_WORDS(laneCount));
+}
+
+// 局号 [first, last) 全部跑完，结果记入 stats
+void runLanes(Lanes* l, ComboStats* stats, int combo, int first, int last) {
+    CharacterType ch = (CharacterType)(combo / LEVEL_COUNT);
+    DifficultyLevel lv = (DifficultyLevel)(combo % LEVEL_COUNT);
+    RRBoxColumns dinos = {l->dinoX.data(), l->dinoY.data(), l->dinoWidth.data(), l->dinoHeight.data()};
+    RRBoxColumns nth = {l->obsX.data(), l->obsY.data(), l->obsWidth.data(), l->obsHeight.data()};
+    int next = first, active = 0;
+
+    for (int i = 0; i < laneCount && next < last; i++, next++) {
+        l->runs[i] = next;
+        rrInitWorld(&l->worlds[i], ch, lv, runSeed(combo, next));
+        policyInit(&l->policies[i], runSeed(combo, next));
+        active++;
+    }
+
+    while (active > 0) {
+        int maxCount = 0;
+        for (int i = 0; i < laneCount; i++) {
+            if (l->runs[i] < 0) continue;
+            RRWorld* w = &l->worlds[i];
+            RRStepSweep* s = &l->sweeps[i];
+            RRInput input;
+            choosePolicyInput(w, &l->policies[i], &input);
+            rrStepMove(w, &input, s);
+            RRSweepBox box = rrStepSweepBox(w, s);
+            l->dinoX[i] = box.x0;
+            l->dinoY[i] = box.y0;
+            l->dinoWidth[i] = box.x1 - box.x0;
+            l->dinoHeight[i] = box.y1 - box.y0;
+            if (w->obstacles.count > maxCount) maxCount = w->obstacles.count;
+        }
+
+        memset(l->hits.data(), 0, sizeof(uint32_t) * l->hits.size());
+        for (int k = 0; k < maxCount; k++) {
+            for (int i = 0; i < laneCount; i++) {
+                const RRObstaclePool* obs = &l->worlds[i].obstacles;
+                if (l->runs[i] >= 0 && k < obs->count) {
+                    l->obsX[i] = obs->x[k];
+                    l->obsY[i] = obs->y[k];
+                    l->obsWidth[i] = obs->width[k];
+                    l->obsHeight[i] = obs->height[k];
+                } else {
+                    l->obsX[i] = INT_MIN / 2;       // 碰不到任何盒子
+                    l->obsY[i] = 0;
+                    l->obsWidth[i] = 0;
+                    l->obsHeight[i] = 0;
+                }
+            }
+            rrCollideLanes(&dinos, &nth, laneCount, l->mask.data());
+            for (size_t j = 0; j < l->hits.size(); j++) l->hits[j] |= l->mask[j];
+        }
+
+        for (int i = 0; i < laneCount; i++) {
+            if (l->runs[i] < 0) continue;
+            RRWorld* w = &l->worlds[i];
+            rrStepFinish(w, &l->sweeps[i], (l->hits[i >> 5] >> (i & 31)) & 1);
+            if (!w->gameOver && w->frameCount < maxSteps) continue;
+
+            recordRun(stats, w);
+            if (next < last) {
+                l->runs[i] = next;
+                rrInitWorld(w, ch, lv, runSeed(combo, next));
+                policyInit(&l->policies[i], runSeed(combo, next));
+                next++;
+            } else {
+                l->runs[i] = -1;
+                active--;
+            }
+        }
+    }
+}
+
+// --- 工作线程: 按块领取任务，只写自己的统计，最后再合并 ---
+void workerMain(ThreadStats* stats) {
+    long long chunksPerCombo = (runsPerCombo + RUNS_PER_CHUNK - 1) / RUNS_PER_CHUNK;
+    long long totalChunks = chunksPerCombo * COMBO_COUNT;
+    Lanes lanes;
+    if (laneCount > 0) lanesInit(&lanes);
+
+    for (;;) {
+        long long chunk = nextChunk.fetch_add(1);
+        if (chunk >= totalChunks) break;
+
+        int combo = (int)(chunk / chunksPerCombo);
+        int first = (int)(chunk % chunksPerCombo) * RUNS_PER_CHUNK;
+        int last = first + RUNS_PER_CHUNK;
+        if (last > runsPerCombo) last = runsPerCombo;
+
+        if (laneCount > 0) {
+            runLanes(&lanes, &stats->combos[combo], combo, first, last);
+            continue;
+        }
+        CharacterType ch = (CharacterType)(combo / LEVEL_COUNT);
+        DifficultyLevel lv = (DifficultyLevel)(combo % LEVEL_COUNT);
+        for (int run = first; run < last; run++) {
+            runOne(&stats->combos[combo], ch, lv, runSeed(combo, run));
+        }
+    }
+}
+
+// --- 报告 ---
+int scorePercentile(const ComboStats* s, double p) {
+    long long target = (long long)(s->runs * p);
+    long long acc = 0;
+    for (int i = 0; i < scoreSlots; i++) {
+        acc += s->scoreCounts[i];
+        if (acc > target) return i * SCORE_STEP;
+    }
+    return (scoreSlots - 1) * SCORE_STEP;
+}
+
+void printReport(const ComboStats* s, int combo) {
+    const CharacterConfig* ch = &charConfigs[combo / LEVEL_COUNT];
+    const GameConfig* lv = &levelConfigs[combo % LEVEL_COUNT];
+
+    printf("\n=== %s x %s (%lld 局) ===\n", ch->name, lv->name, s->runs);
+    printf("平均分数: %.1f   平均存活: %.1f 秒\n",
+           (double)s->scoreSum / s->runs, (double)s->stepSum / s->runs / 60.0);
+    printf("分数分位: P10=%d P50=%d P90=%d P99=%d\n",
+           scorePercentile(s, 0.10), scorePercentile(s, 0.50),
+           scorePercentile(s, 0.90), scorePercentile(s, 0.99));
+
+    printf("存活曲线:");
+    long long alive = s->runs;
+    for (int i = 0; i < SURVIVAL_BINS; i++) {
+        alive -= s->deathsInBin[i];
+        if (i % 4 == 3) {
+            printf(" %ds:%.1f%%", (i + 1) * maxSteps / SURVIVAL_BINS / 60, 100.0 * alive / s->runs);
+        }
+    }
+    printf("\n");
+
+    printf("死因:");
+    for (int i = 0; i < CAUSE_COUNT; i++) {
+        printf(" %s %.1f%%", causeNames[i], 100.0 * s->causes[i] / s->runs);
+    }
+    printf("\n");
+
+    // 按实际出现的最高分分行
+    int top = 0;
+    for (int i = 0; i < scoreSlots; i++) {
+        if (s->scoreCounts[i] != 0) top = i;
+    }
+    int rowSlots = top / SCORE_ROWS + 1;
+    printf("分数直方图 (每格 %d 分):\n", rowSlots * SCORE_STEP);
+    for (int first = 0; first <= top; first += rowSlots) {
+        long long count = 0;
+        for (int i = first; i < first + rowSlots && i < scoreSlots; i++) count += s->scoreCounts[i];
+        if (count == 0) continue;
+        int bar = (int)(60 * count / s->runs);
+        printf("  %6d %6.2f%% ", first * SCORE_STEP, 100.0 * count / s->runs);
+        for (int j = 0; j < bar; j++) putchar('#');
+        putchar('\n');
+    }
+}
+
+// --- 主函数 ---
+int main(int argc, char** argv) {
+    if (argc > 1) runsPerCombo = atoi(argv[1]);
+    if (argc > 2) threadCount = atoi(argv[2]);
+    if (argc > 3) maxSteps = atoi(argv[3]);
+    if (argc > 4) baseSeed = (unsigned int)strtoul(argv[4], NULL, 10);
+    if (argc > 5) laneCount = atoi(argv[5]);
+    if (threadCount <= 0) threadCount = (int)std::thread::hardware_concurrency();
+    if (threadCount <= 0) threadCount = 1;
+    if (runsPerCombo <= 0 || maxSteps <= 0 || laneCount < 0 || laneCount > MAX_LANES) {
+        printf("用法: rr_balance [每组局数] [线程数] [每局最大步数] [种子] [通道数]\n");
+        return 1;
+    }
+
+    // 一步最多生成一个障碍物，所以分数不超过 maxSteps * SCORE_STEP，逐格计数不会溢出
+    scoreSlots = maxSteps + 1;
+    std::vector<ThreadStats> stats(threadCount);
+    memset(stats.data(), 0, sizeof(ThreadStats) * threadCount);
+    std::vector<long long> scoreCounts((size_t)(threadCount + 1) * COMBO_COUNT * scoreSlots, 0);
+    for (int t = 0; t < threadCount; t++) {     // 最后一份留给合并后的总数
+        for (int c = 0; c < COMBO_COUNT; c++) {
+            stats[t].combos[c].scoreCounts = &scoreCounts[((size_t)t * COMBO_COUNT + c) * scoreSlots];
+        }
+    }
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threadCount; i++) {
+        workers.push_back(std::thread(workerMain, &stats[i]));
+    }
+    for (int i = 0; i < threadCount; i++) {
+        workers[i].join();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    // 合并各线程的统计
+    ComboStats total[COMBO_COUNT];
+    memset(total, 0, sizeof(total));
+    for (int c = 0; c < COMBO_COUNT; c++) {
+        total[c].scoreCounts = &scoreCounts[((size_t)threadCount * COMBO_COUNT + c) * scoreSlots];
+    }
+    long long totalSteps = 0;
+    for (int t = 0; t < threadCount; t++) {
+        for (int c = 0; c < COMBO_COUNT; c++) {
+            const ComboStats* s = &stats[t].combos[c];
+            total[c].runs += s->runs;
+            total[c].scoreSum += s->scoreSum;
+            total[c].stepSum += s->stepSum;
+            for (int i = 0; i < SURVIVAL_BINS; i++) total[c].deathsInBin[i] += s->deathsInBin[i];
+            for (int i = 0; i < scoreSlots; i++) total[c].scoreCounts[i] += s->scoreCounts[i];
+            for (int i = 0; i < CAUSE_COUNT; i++) total[c].causes[i] += s->causes[i];
+            totalSteps += s->stepSum;
+        }
+    }
+
+    printf("共 %d 组 x %d 局, %d 线程, %d 通道, 用时 %.2f 秒, %.1f M步/秒\n",
+           COMBO_COUNT, runsPerCombo, threadCount, laneCount, seconds, totalSteps / seconds / 1e6);
+    for (int c = 0; c < COMBO_COUNT; c++) {
+        printReport(&total[c], c);
+    }
+    return 0;
+}
@@ -0,0 +1,540 @@
+/*
+ * 文件名: rr_batch.cpp
+ * 描述: 绘制命令缓冲 + 按状态分批
+ *       分批: 按录制顺序处理，每条命令从最后一批往前找同状态的批次，
+ *             中途碰到外接框相交的批次就停 (再往前挪会改变遮挡关系)，找不到就新开一批
+ *       提交: 按批次顺序，每批内部按录制顺序
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "rr_batch.h"
+
+// --- 图元类型 ---
+enum {
+    CMD_CLEAR,
+    CMD_SOLID_RECT,
+    CMD_RECT,
+    CMD_SOLID_ELLIPSE,
+    CMD_ELLIPSE,
+    CMD_SOLID_CIRCLE,
+    CMD_POLYGON,
+    CMD_LINE,
+    CMD_TEXT,
+    CMD_LAYER
+};
+
+// --- 状态类别 (对应 EasyX 的哪一个颜色状态) ---
+enum {
+    STATE_FILL = 1,
+    STATE_LINE,
+    STATE_TEXT,
+    STATE_LAYER         // 贴图层: 不和任何命令同批
+};
+
+struct RRBatchCmd {
+    RRBatchCmd* next;           // 录制顺序
+    RRBatchCmd* batchNext;      // 同一批里的下一条
+    int op;
+    int a, b, c, d;
+    RRColor color;
+    int textHeight;
+    int count;                  // 顶点数
+    void* layer;
+    const void* data;           // 文字 / 顶点 (在内存池里)
+    RRRect bounds;
+};
+
+typedef struct {
+    uint64_t key;
+    RRBatchCmd* head;
+    RRBatchCmd* tail;
+    RRRect bounds;
+} Batch;
+
+static int stateClass(int op) {
+    switch (op) {
+        case CMD_RECT:
+        case CMD_ELLIPSE:
+        case CMD_LINE:
+            return STATE_LINE;
+        case CMD_TEXT:
+            return STATE_TEXT;
+        case CMD_LAYER:
+            return STATE_LAYER;
+        default:
+            return STATE_FILL;
+    }
+}
+
+static uint64_t stateKey(const RRBatchCmd* cmd) {
+    int cls = stateClass(cmd->op);
+    uint64_t key = ((uint64_t)cls << 56) | cmd->color;
+    if (cls == STATE_TEXT) key |= (uint64_t)(uint32_t)cmd->textHeight << 24;
+    return key;
+}
+
+// --- 录制 ---
+static RRBatchCmd* pushCmd(RRBatcher* b, int op, RRColor color) {
+    RRBatchCmd* cmd = (RRBatchCmd*)rrArenaAlloc(&b->arena, sizeof(RRBatchCmd));
+    if (cmd == NULL) return NULL;
+    memset(cmd, 0, sizeof(RRBatchCmd));
+    cmd->op = op;
+    cmd->color = color;
+    if (b->last != NULL) {
+        b->last->next = cmd;
+    } else {
+        b->first = cmd;
+    }
+    b->last = cmd;
+    b->pending++;
+    return cmd;
+}
+
+static void recordBox(RRBatcher* b, int op, int left, int top, int right, int bottom, RRColor color) {
+    RRBatchCmd* cmd = pushCmd(b, op, color);
+    if (cmd == NULL) return;
+    cmd->bounds = rrRectMake(left, top, right, bottom);
+    if (op == CMD_LINE) {
+        cmd->a = left;
+        cmd->b = top;
+        cmd->c = right;
+        cmd->d = bottom;
+    } else {
+        // 矩形和椭圆两个角的顺序不影响结果，统一成左上 / 右下方便合并
+        cmd->a = cmd->bounds.left;
+        cmd->b = cmd->bounds.top;
+        cmd->c = cmd->bounds.right;
+        cmd->d = cmd->bounds.bottom;
+    }
+}
+
+static void batchClear(void* impl, RRColor color) {
+    RRBatcher* b = (RRBatcher*)impl;
+    recordBox(b, CMD_CLEAR, 0, 0, b->target->width - 1, b->target->height - 1, color);
+}
+
+static void batchSolidRect(void* impl, int left, int top, int right, int bottom, RRColor color) {
+    recordBox((RRBatcher*)impl, CMD_SOLID_RECT, left, top, right, bottom, color);
+}
+
+static void batchRect(void* impl, int left, int top, int right, int bottom, RRColor color) {
+    recordBox((RRBatcher*)impl, CMD_RECT, left, top, right, bottom, color);
+}
+
+static void batchSolidEllipse(void* impl, int left, int top, int right, int bottom, RRColor color) {
+    recordBox((RRBatcher*)impl, CMD_SOLID_ELLIPSE, left, top, right, bottom, color);
+}
+
+static void batchEllipse(void* impl, int left, int top, int right, int bottom, RRColor color) {
+    recordBox((RRBatcher*)impl, CMD_ELLIPSE, left, top, right, bottom, color);
+}
+
+static void batchSolidCircle(void* impl, int x, int y, int radius, RRColor color) {
+    RRBatcher* b = (RRBatcher*)impl;
+    RRBatchCmd* cmd = pushCmd(b, CMD_SOLID_CIRCLE, color);
+    if (cmd == NULL) return;
+    cmd->a = x;
+    cmd->b = y;
+    cmd->c = radius;
+    cmd->bounds = rrRectMake(x - radius, y - radius, x + radius, y + radius);
+}
+
+static void batchSolidPolygon(void* impl, const RRPoint* points, int count, RRColor color) {
+    RRBatcher* b = (RRBatcher*)impl;
+    if (count <= 0) return;
+    RRPoint* copy = (RRPoint*)rrArenaAlloc(&b->arena, sizeof(RRPoint) * count);
+    if (copy == NULL) return;
+    memcpy(copy, points, sizeof(RRPoint) * count);
+    RRBatchCmd* cmd = pushCmd(b, CMD_POLYGON, color);
+    if (cmd == NULL) return;
+    cmd->count = count;
+    cmd->data = copy;
+    cmd->bounds = rrRectMake(points[0].x, points[0].y, points[0].x, points[0].y);
+    for (int i = 1; i < count; i++) {
+        cmd->bounds = rrRectUnion(cmd->bounds, rrRectMake(points[i].x, points[i].y, points[i].x, points[i].y));
+    }
+}
+
+static void batchLine(void* impl, int x1, int y1, int x2, int y2, RRColor color) {
+    recordBox((RRBatcher*)impl, CMD_LINE, x1, y1, x2, y2, color);
+}
+
+static int batchTextWidth(void* impl, const char* text, int height) {
+    RRBatcher* b = (RRBatcher*)impl;
+    return b->target->ops->textWidth(b->target->impl, text, height);
+}
+
+static void batchText(void* impl, int x, int y, const char* text, int height, RRColor color) {
+    RRBatcher* b = (RRBatcher*)impl;
+    size_t size = strlen(text) + 1;
+    char* copy = (char*)rrArenaAlloc(&b->arena, size);
+    if (copy == NULL) return;
+    memcpy(copy, text, size);
+    int width = batchTextWidth(impl, text, height);
+    RRBatchCmd* cmd = pushCmd(b, CMD_TEXT, color);
+    if (cmd == NULL) return;
+    cmd->a = x;
+    cmd->b = y;
+    cmd->textHeight = height;
+    cmd->data = copy;
+    cmd->bounds = rrRectMake(x, y, x + width - 1, y + height - 1);
+}
+
+static void batchDrawLayer(void* impl, void* layer, int x, int y, int width, int height) {
+    RRBatcher* b = (RRBatcher*)impl;
+    RRBatchCmd* cmd = pushCmd(b, CMD_LAYER, 0);
+    if (cmd == NULL) return;
+    cmd->a = x;
+    cmd->b = y;
+    cmd->c = width;
+    cmd->d = height;
+    cmd->layer = layer;
+    cmd->bounds = rrRectMake(x, y, x + width - 1, y + height - 1);
+}
+
+// --- 转储 ---
+static void dumpColor(FILE* f, RRColor c) {
+    fprintf(f, " %06X", (unsigned)c);
+}
+
+static void dumpCmd(FILE* f, const RRBatchCmd* cmd) {
+    switch (cmd->op) {
+        case CMD_CLEAR:
+            fprintf(f, "clear");
+            dumpColor(f, cmd->color);
+            break;
+        case CMD_SOLID_RECT:
+            fprintf(f, "srect %d %d %d %d", cmd->a, cmd->b, cmd->c, cmd->d);
+            dumpColor(f, cmd->color);
+            break;
+        case CMD_RECT:
+            fprintf(f, "rect %d %d %d %d", cmd->a, cmd->b, cmd->c, cmd->d);
+            dumpColor(f, cmd->color);
+            break;
+        case CMD_SOLID_ELLIPSE:
+            fprintf(f, "sellipse %d %d %d %d", cmd->a, cmd->b, cmd->c, cmd->d);
+            dumpColor(f, cmd->color);
+            break;
+        case CMD_ELLIPSE:
+            fprintf(f, "ellipse %d %d %d %d", cmd->a, cmd->b, cmd->c, cmd->d);
+            dumpColor(f, cmd->color);
+            break;
+        case CMD_SOLID_CIRCLE:
+            fprintf(f, "circle %d %d %d", cmd->a, cmd->b, cmd->c);
+            dumpColor(f, cmd->color);
+            break;
+        case CMD_POLYGON: {
+            const RRPoint* p = (const RRPoint*)cmd->data;
+            fprintf(f, "poly");
+            dumpColor(f, cmd->color);
+            fprintf(f, " %d", cmd->count);
+            for (int i = 0; i < cmd->count; i++) fprintf(f, " %d %d", p[i].x, p[i].y);
+            break;
+        }
+        case CMD_LINE:
+            fprintf(f, "line %d %d %d %d", cmd->a, cmd->b, cmd->c, cmd->d);
+            dumpColor(f, cmd->color);
+            break;
+        case CMD_TEXT:
+            // 文字放在行尾，本身不含换行
+            fprintf(f, "text %d %d %d", cmd->a, cmd->b, cmd->textHeight);
+            dumpColor(f, cmd->color);
+            fprintf(f, " %s", (const char*)cmd->data);
+            break;
+        case CMD_LAYER:
+            fprintf(f, "layer %d %d %d %d", cmd->a, cmd->b, cmd->c, cmd->d);
+            break;
+    }
+    fputc('\n', f);
+}
+
+// --- 提交 ---
+static void submitCmd(RRRenderer* t, const RRBatchCmd* cmd) {
+    switch (cmd->op) {
+        case CMD_CLEAR:
+            t->ops->clear(t->impl, cmd->color);
+            break;
+        case CMD_SOLID_RECT:
+            t->ops->solidRect(t->impl, cmd->a, cmd->b, cmd->c, cmd->d, cmd->color);
+            break;
+        case CMD_RECT:
+            t->ops->rect(t->impl, cmd->a, cmd->b, cmd->c, cmd->d, cmd->color);
+            break;
+        case CMD_SOLID_ELLIPSE:
+            t->ops->solidEllipse(t->impl, cmd->a, cmd->b, cmd->c, cmd->d, cmd->color);
+            break;
+        case CMD_ELLIPSE:
+            t->ops->ellipse(t->impl, cmd->a, cmd->b, cmd->c, cmd->d, cmd->color);
+            break;
+        case CMD_SOLID_CIRCLE:
+            t->ops->solidCircle(t->impl, cmd->a, cmd->b, cmd->c, cmd->color);
+            break;
+        case CMD_POLYGON:
+            t->ops->solidPolygon(t->impl, (const RRPoint*)cmd->data, cmd->count, cmd->color);
+            break;
+        case CMD_LINE:
+            t->ops->line(t->impl, cmd->a, cmd->b, cmd->c, cmd->d, cmd->color);
+            break;
+        case CMD_TEXT:
+            t->ops->text(t->impl, cmd->a, cmd->b, (const char*)cmd->data, cmd->textHeight, cmd->color);
+            break;
+        case CMD_LAYER:
+            t->ops->drawLayer(t->impl, cmd->layer, cmd->a, cmd->b, cmd->c, cmd->d);
+            break;
+    }
+}
+
+// 按 EasyX 的做法数状态切换: 填充色、线条色、文字色 + 字号各自缓存，变了才算一次
+typedef struct {
+    uint64_t fill, line, text;
+    int changes;
+} StateCounter;
+
+static void countState(StateCounter* s, const RRBatchCmd* cmd) {
+    uint64_t key = stateKey(cmd);
+    uint64_t* slot;
+    switch (stateClass(cmd->op)) {
+        case STATE_FILL: slot = &s->fill; break;
+        case STATE_LINE: slot = &s->line; break;
+        case STATE_TEXT: slot = &s->text; break;
+        default: return;
+    }
+    if (*slot != key) {
+        *slot = key;
+        s->changes++;
+    }
+}
+
+// 同一批里两个实心矩形拼起来正好还是矩形时，把 cmd 并进 tail
+static int mergeRect(RRBatchCmd* tail, const RRBatchCmd* cmd) {
+    if (tail->op != CMD_SOLID_RECT || cmd->op != CMD_SOLID_RECT) return 0;
+    if (tail->a == cmd->a && tail->c == cmd->c && cmd->b <= tail->d + 1 && tail->b <= cmd->d + 1) {
+        if (cmd->b < tail->b) tail->b = cmd->b;
+        if (cmd->d > tail->d) tail->d = cmd->d;
+    } else if (tail->b == cmd->b && tail->d == cmd->d && cmd->a <= tail->c + 1 && tail->a <= cmd->c + 1) {
+        if (cmd->a < tail->a) tail->a = cmd->a;
+        if (cmd->c > tail->c) tail->c = cmd->c;
+    } else {
+        return 0;
+    }
+    tail->bounds = rrRectMake(tail->a, tail->b, tail->c, tail->d);
+    return 1;
+}
+
+// 分批并提交还没画的命令
+static void flush(RRBatcher* b) {
+    if (b->pending == 0) return;
+    RRRenderer* t = b->target;
+    Batch* batches = (Batch*)rrArenaAlloc(&b->arena, sizeof(Batch) * b->pending);
+    StateCounter before = {0, 0, 0, 0}, after = {0, 0, 0, 0};
+    int count = 0, merged = 0;
+
+    if (batches == NULL) {
+        // 内存不够就按原顺序画
+        for (RRBatchCmd* cmd = b->first; cmd != NULL; cmd = cmd->next) submitCmd(t, cmd);
+    } else {
+        for (RRBatchCmd* cmd = b->first; cmd != NULL;) {
+            RRBatchCmd* next = cmd->next;
+            countState(&before, cmd);
+            uint64_t key = stateKey(cmd);
+            int text = (stateClass(cmd->op) == STATE_TEXT);
+            Batch* join = NULL;
+            if (stateClass(cmd->op) != STATE_LAYER) {
+                for (int k = count - 1; k >= 0 && k >= count - RR_BATCH_LOOKBACK; k--) {
+                    Batch* bt = &batches[k];
+                    int overlap = rrRectOverlap(bt->bounds, cmd->bounds);
+                    if (bt->key == key && !(text && overlap)) {
+                        join = bt;
+                        break;
+                    }
+                    if (overlap) break;
+                }
+            }
+            cmd->batchNext = NULL;
+            if (join == NULL) {
+                join = &batches[count++];
+                join->key = key;
+                join->head = join->tail = cmd;
+                join->bounds = cmd->bounds;
+            } else if (mergeRect(join->tail, cmd)) {
+                join->bounds = rrRectUnion(join->bounds, join->tail->bounds);
+                merged++;
+            } else {
+                join->tail->batchNext = cmd;
+                join->tail = cmd;
+                join->bounds = rrRectUnion(join->bounds, cmd->bounds);
+            }
+            cmd = next;
+        }
+
+        for (int k = 0; k < count; k++) {
+            if (b->dump) fprintf(b->dump, "# 第 %d 批\n", b->batches + k);
+            for (RRBatchCmd* cmd = batches[k].head; cmd != NULL; cmd = cmd->batchNext) {
+                countState(&after, cmd);
+                if (b->dump) dumpCmd(b->dump, cmd);
+                submitCmd(t, cmd);
+            }
+        }
+    }
+
+    b->cmds += b->pending;
+    b->batches += count;
+    b->merged += merged;
+    b->changesBefore += before.changes;
+    b->changesAfter += after.changes;
+    b->first = b->last = NULL;
+    b->pending = 0;
+}
+
+// --- 直接转给后端的操作 (先把前面的命令画掉) ---
+static void batchSetClip(void* impl, int left, int top, int right, int bottom) {
+    RRBatcher* b = (RRBatcher*)impl;
+    flush(b);
+    if (b->dump) fprintf(b->dump, "clip %d %d %d %d\n", left, top, right, bottom);
+    b->target->ops->setClip(b->target->impl, left, top, right, bottom);
+}
+
+static void* batchCreateLayer(void* impl, int width, int height) {
+    RRBatcher* b = (RRBatcher*)impl;
+    return b->target->ops->createLayer(b->target->impl, width, height);
+}
+
+static void batchFreeLayer(void* impl, void* layer) {
+    RRBatcher* b = (RRBatcher*)impl;
+    b->target->ops->freeLayer(b->target->impl, layer);
+}
+
+static void batchBeginLayer(void* impl, void* layer) {
+    RRBatcher* b = (RRBatcher*)impl;
+    flush(b);
+    if (b->dump) fprintf(b->dump, (layer != NULL) ? "layer_begin\n" : "layer_end\n");
+    b->inLayer = (layer != NULL);
+    b->target->ops->beginLayer(b->target->impl, layer);
+}
+
+static void batchPresent(void* impl) {
+    RRBatcher* b = (RRBatcher*)impl;
+    flush(b);
+    b->target->ops->present(b->target->impl);
+    if (b->dump) {
+        fprintf(b->dump, "# 共 %d 条命令 %d 批，状态切换 %d -> %d\n", b->cmds, b->batches, b->changesBefore,
+                b->changesAfter);
+        fclose(b->dump);
+        b->dump = NULL;
+    }
+
+    b->lastCmds = b->cmds;
+    b->lastBatches = b->batches;
+    b->lastMerged = b->merged;
+    b->lastChangesBefore = b->changesBefore;
+    b->lastChangesAfter = b->changesAfter;
+    b->cmds = b->batches = b->merged = b->changesBefore = b->changesAfter = 0;
+    rrArenaReset(&b->arena);
+}
+
+static const RRRenderOps batchOps = {
+    batchClear,
+    batchSolidRect,
+    batchRect,
+    batchSolidEllipse,
+    batchEllipse,
+    batchSolidCircle,
+    batchSolidPolygon,
+    batchLine,
+    batchText,
+    batchTextWidth,
+    batchSetClip,
+    batchCreateLayer,
+    batchFreeLayer,
+    batchBeginLayer,
+    batchDrawLayer,
+    batchPresent
+};
+
+void rrBatchInit(RRRenderer* r, RRBatcher* b, RRRenderer* target) {
+    memset(b, 0, sizeof(RRBatcher));
+    b->target = target;
+    rrArenaInit(&b->arena, 64 * 1024);
+    rrRendererInit(r, &batchOps, b, target->width, target->height);
+}
+
+void rrBatchFree(RRBatcher* b) {
+    rrArenaFree(&b->arena);
+    memset(b, 0, sizeof(RRBatcher));
+}
+
+// --- 重放转储 ---
+static int parseColor(const char* s, RRColor* c) {
+    char* end;
+    unsigned long v = strtoul(s, &end, 16);
+    if (end == s) return 0;
+    *c = (RRColor)v;
+    return 1;
+}
+
+int rrBatchReplayDump(FILE* in, RRRenderer* r) {
+    static char line[65536];
+    static RRPoint points[4096];
+    int drawn = 0, layerDepth = 0;
+    while (fgets(line, sizeof(line), in)) {
+        size_t n = strlen(line);
+        while (n > 0 && (line[n - 1] == '\n' || line[n - 1] == '\r')) line[--n] = 0;
+        if (n == 0 || line[0] == '#') continue;
+
+        char op[16], color[16];
+        int a, b, c, d, consumed = 0;
+        RRColor col = 0;
+        if (sscanf(line, "%15s%n", op, &consumed) != 1) return -1;
+        const char* args = line + consumed;
+
+        // 图层的内容不在屏幕上，跳过 (贴图层也画不出来: 转储里没有图层的像素)
+        if (strcmp(op, "layer_begin") == 0) {
+            layerDepth++;
+            continue;
+        }
+        if (strcmp(op, "layer_end") == 0) {
+            if (layerDepth > 0) layerDepth--;
+            continue;
+        }
+        if (layerDepth > 0 || strcmp(op, "layer") == 0) continue;
+
+        if (strcmp(op, "clear") == 0) {
+            if (sscanf(args, "%15s", color) != 1 || !parseColor(color, &col)) return -1;
+            r->ops->clear(r->impl, col);
+        } else if (strcmp(op, "circle") == 0) {
+            if (sscanf(args, "%d %d %d %15s", &a, &b, &c, color) != 4 || !parseColor(color, &col)) return -1;
+            r->ops->solidCircle(r->impl, a, b, c, col);
+        } else if (strcmp(op, "clip") == 0) {
+            if (sscanf(args, "%d %d %d %d", &a, &b, &c, &d) != 4) return -1;
+            r->ops->setClip(r->impl, a, b, c, d);
+            continue;
+        } else if (strcmp(op, "poly") == 0) {
+            int count, used;
+            if (sscanf(args, "%15s %d%n", color, &count, &used) != 2 || !parseColor(color, &col)) return -1;
+            if (count <= 0 || count > 4096) return -1;
+            args += used;
+            for (int i = 0; i < count; i++) {
+                if (sscanf(args, "%d %d%n", &points[i].x, &points[i].y, &used) != 2) return -1;
+                args += used;
+            }
+            r->ops->solidPolygon(r->impl, points, count, col);
+        } else if (strcmp(op, "text") == 0) {
+            int used;
+            if (sscanf(args, "%d %d %d %15s%n", &a, &b, &c, color, &used) != 4 || !parseColor(color, &col)) return -1;
+            args += used;
+            if (*args == ' ') args++;
+            r->ops->text(r->impl, a, b, args, c, col);
+        } else {
+            if (sscanf(args, "%d %d %d %d %15s", &a, &b, &c, &d, color) != 5 || !parseColor(color, &col)) return -1;
+            if (strcmp(op, "srect") == 0) r->ops->solidRect(r->impl, a, b, c, d, col);
+            else if (strcmp(op, "rect") == 0) r->ops->rect(r->impl, a, b, c, d, col);
+            else if (strcmp(op, "sellipse") == 0) r->ops->solidEllipse(r->impl, a, b, c, d, col);
+            else if (strcmp(op, "ellipse") == 0) r->ops->ellipse(r->impl, a, b, c, d, col);
+            else if (strcmp(op, "line") == 0) r->ops->line(r->impl, a, b, c, d, col);
+            else return -1;
+        }
+        drawn++;
+    }
+    return drawn;
+}
@@ -0,0 +1,51 @@
+/*
+ * 文件名: rr_batch.h
+ * 描述: 绘制命令缓冲 + 按状态分批: 本身是一个绘制后端，图元先记进本帧的命令缓冲 (内存池分配)，
+ *       到裁剪 / 图层切换 / present 时按状态分批再交给真正的后端
+ *       状态 = 填充色 / 线条色 / 文字色 + 字号；同状态的图元排到一起，EasyX 就不用来回 setfillcolor
+ *       画家算法的前后关系不变: 一条命令只能往前挪过和它外接框不相交的批次，
+ *       同一批里都是同一种颜色，谁先谁后像素都一样 (文字带黑底，只有互不相交时才同批)
+ *       同一批里上下或左右正好接上的实心矩形合并成一个 (长 span 填充)
+ *       可以把一帧实际提交的命令按顺序转储成文本，之后用 rrBatchReplayDump 画到任何后端上重现
+ *       实测 (rr_render_bench) 每个画面都比直接画慢: 状态切换几乎没减少，相邻矩形的合并也碰不上，
+ *       所以游戏里平时不走它，只在转储的那一帧接进去
+ */
+#ifndef RR_BATCH_H
+#define RR_BATCH_H
+
+#include <stdio.h>
+
+#include "rr_arena.h"
+#include "rr_render.h"
+
+#define RR_BATCH_LOOKBACK 64        // 找同状态批次时最多往回看这么多批
+
+typedef struct RRBatchCmd RRBatchCmd;
+
+typedef struct {
+    RRRenderer* target;
+    RRArena arena;              // 本帧的命令和附带数据，present 后整体归零
+    RRBatchCmd* first;          // 还没提交的命令 (录制顺序)
+    RRBatchCmd* last;
+    int pending;
+    int inLayer;                // 正在画图层 (转储时标出来)
+    FILE* dump;                 // 非 NULL 时下一次 present 前提交的命令都写进去，present 时关闭并清空
+
+    // 统计: 本帧累计 / 上一帧
+    int cmds, batches, merged;
+    int changesBefore, changesAfter;
+    int lastCmds;
+    int lastBatches;
+    int lastMerged;             // 合并掉的矩形数
+    int lastChangesBefore;      // EasyX 状态切换次数: 按录制顺序画 / 按分批后的顺序画
+    int lastChangesAfter;
+} RRBatcher;
+
+// r 接到命令缓冲上，分批后画到 target
+void rrBatchInit(RRRenderer* r, RRBatcher* b, RRRenderer* target);
+void rrBatchFree(RRBatcher* b);
+
+// 重放 rrBatcher.dump 写出的转储，返回画了多少条命令，格式错误返回 -1
+int rrBatchReplayDump(FILE* in, RRRenderer* r);
+
+#endif
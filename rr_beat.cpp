@@ -0,0 +1,473 @@
+/*
+ * 文件名: rr_beat.cpp
+ * 描述: 离线节拍分析
+ *       1. 解码 WAV，混成单声道，整数倍降采样到不高于 RR_BEAT_RATE
+ *       2. 短时傅里叶变换 (汉宁窗 + 基 2 FFT)，对数幅度谱逐帧求正向差之和 = 频谱通量
+ *       3. 减去局部均值并半波整流，得到起音包络
+ *       4. 包络自相关 (按 120 BPM 附近加权) 估计拍长
+ *       5. 动态规划找一串既落在起音上、间隔又接近拍长的时刻 (Ellis 2007)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "rr_beat.h"
+
+#define BEAT_PI 3.14159265358979323846
+#define BEAT_BINS (RR_BEAT_FRAME / 2 + 1)
+#define BEAT_MEAN_WINDOW 16         // 局部均值窗口 (帧，两侧各一半)
+#define BEAT_TEMPO_CENTER 120.0     // 速度先验的中心 (BPM)
+#define BEAT_TEMPO_SPREAD 1.0       // 速度先验的宽度 (以 2 为底的对数，即倍频程)
+#define BEAT_TIGHTNESS 400.0        // 拍间隔偏离拍长的惩罚系数
+
+// --- 小端读取 ---
+static unsigned int readU16(const unsigned char* p) {
+    return p[0] | (p[1] << 8);
+}
+
+static unsigned int readU32(const unsigned char* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+// 第 i 个采样点 (bits 位整数或 32 位浮点) 转成 [-1, 1]
+static float decodeSample(const unsigned char* p, int bits, int isFloat) {
+    if (isFloat) {
+        float f;
+        memcpy(&f, p, 4);
+        return f;
+    }
+    switch (bits) {
+        case 8: return (p[0] - 128) / 128.0f;
+        case 16: return (short)readU16(p) / 32768.0f;
+        case 24: return ((int)(readU32(p) << 8) >> 8) / 8388608.0f;   // 借用下一字节后移掉
+        default: return (int)readU32(p) / 2147483648.0f;
+    }
+}
+
+// --- WAV 解码 ---
+int rrBeatLoadWav(const char* path, float** samples, int* count, int* rate) {
+    FILE* fp = fopen(path, "rb");
+    if (fp == NULL) return 0;
+
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size < 12) {
+        fclose(fp);
+        return 0;
+    }
+
+    // 多读 1 字节，24 位解码读 4 字节时不会越界
+    unsigned char* buf = (unsigned char*)malloc(size + 1);
+    if (buf == NULL || fread(buf, 1, size, fp) != (size_t)size) {
+        free(buf);
+        fclose(fp);
+        return 0;
+    }
+    fclose(fp);
+    buf[size] = 0;
+
+    int ok = 0;
+    int channels = 0, bits = 0, isFloat = 0, sampleRate = 0;
+    const unsigned char* data = NULL;
+    size_t dataSize = 0;
+
+    if (memcmp(buf, "RIFF", 4) == 0 && memcmp(buf + 8, "WAVE", 4) == 0) {
+        size_t total = (size_t)size;
+        size_t pos = 12;
+        while (pos + 8 <= total) {
+            size_t chunkSize = readU32(buf + pos + 4);
+            const unsigned char* body = buf + pos + 8;
+            if (chunkSize > total - pos - 8) {
+                // 超出文件的块不可信，不再往后走；只有 data 块按实际长度收 (录音中断或流式写的 0xFFFFFFFF)
+                if (memcmp(buf + pos, "data", 4) != 0) break;
+                chunkSize = total - pos - 8;
+            }
+
+            if (memcmp(buf + pos, "fmt ", 4) == 0 && chunkSize >= 16) {
+                int format = readU16(body);
+                channels = readU16(body + 2);
+                sampleRate = (int)readU32(body + 4);
+                bits = readU16(body + 14);
+                if (format == 0xFFFE && chunkSize >= 26) format = readU16(body + 24); // 扩展格式取子格式
+                isFloat = (format == 3);
+                if (format != 1 && format != 3) channels = 0;
+            } else if (memcmp(buf + pos, "data", 4) == 0) {
+                data = body;
+                dataSize = chunkSize;
+            }
+            pos += 8 + chunkSize + (chunkSize & 1);
+        }
+    }
+
+    int valid = channels > 0 && sampleRate > 0 &&
+                (isFloat ? bits == 32 : (bits == 8 || bits == 16 || bits == 24 || bits == 32));
+    if (valid && data != NULL) {
+        int bytes = bits / 8;
+        int frame = bytes * channels;
+        size_t frames = dataSize / frame;
+        int n = (frames > INT_MAX) ? INT_MAX : (int)frames;
+        float* out = (float*)malloc(sizeof(float) * (n > 0 ? n : 1));
+        if (out != NULL) {
+            float scale = 1.0f / channels;
+            for (int i = 0; i < n; i++) {
+                const unsigned char* p = data + (size_t)i * frame;
+                float sum = 0;
+                for (int c = 0; c < channels; c++) sum += decodeSample(p + c * bytes, bits, isFloat);
+                out[i] = sum * scale;
+            }
+            *samples = out;
+            *count = n;
+            *rate = sampleRate;
+            ok = 1;
+        }
+    }
+
+    free(buf);
+    return ok;
+}
+
+// --- FFT ---
+// 实数输入的 n 点 FFT 用 n/2 点复数 FFT 算: 偶数点作实部、奇数点作虚部，变换后再拆开
+#define FFT_HALF (RR_BEAT_FRAME / 2)
+
+typedef struct {
+    float cosTable[RR_BEAT_FRAME / 2];      // cos(2*pi*k/n)
+    float sinTable[RR_BEAT_FRAME / 2];
+    int bitrev[FFT_HALF];
+    float window[RR_BEAT_FRAME];
+} FFTSetup;
+
+static void initFFT(FFTSetup* s) {
+    int n = RR_BEAT_FRAME;
+    int levels = 0;
+    while ((1 << levels) < FFT_HALF) levels++;
+
+    for (int i = 0; i < n / 2; i++) {
+        s->cosTable[i] = (float)cos(2 * BEAT_PI * i / n);
+        s->sinTable[i] = (float)sin(2 * BEAT_PI * i / n);
+    }
+    for (int i = 0; i < FFT_HALF; i++) {
+        int r = 0;
+        for (int b = 0; b < levels; b++) r |= ((i >> b) & 1) << (levels - 1 - b);
+        s->bitrev[i] = r;
+    }
+    for (int i = 0; i < n; i++) {
+        s->window[i] = (float)(0.5 - 0.5 * cos(2 * BEAT_PI * i / n));
+    }
+}
+
+// FFT_HALF 点复数 FFT (原地)
+static void fftHalf(const FFTSetup* s, float* re, float* im) {
+    int m = FFT_HALF;
+    for (int i = 0; i < m; i++) {
+        int j = s->bitrev[i];
+        if (j > i) {
+            float t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (int size = 2; size <= m; size *= 2) {
+        int half = size / 2;
+        int step = RR_BEAT_FRAME / size;    // 旋转因子表按 n 点建的
+        for (int start = 0; start < m; start += size) {
+            for (int k = 0; k < half; k++) {
+                float wr = s->cosTable[k * step];
+                float wi = -s->sinTable[k * step];
+                int a = start + k, b = a + half;
+                float tr = re[b] * wr - im[b] * wi;
+                float ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+// 加窗后的实数帧 -> 功率谱 power[0..BEAT_BINS)
+static void powerSpectrum(const FFTSetup* s, const float* x, float* power) {
+    float re[FFT_HALF], im[FFT_HALF];
+    for (int i = 0; i < FFT_HALF; i++) {
+        re[i] = x[2 * i] * s->window[2 * i];
+        im[i] = x[2 * i + 1] * s->window[2 * i + 1];
+    }
+    fftHalf(s, re, im);
+
+    // X[k] = E[k] + w^k O[k]，E/O 由 Z[k] 与 conj(Z[m-k]) 拆出
+    for (int k = 0; k <= FFT_HALF; k++) {
+        int a = k & (FFT_HALF - 1), b = (FFT_HALF - k) & (FFT_HALF - 1);
+        float er = 0.5f * (re[a] + re[b]), ei = 0.5f * (im[a] - im[b]);
+        float or_ = 0.5f * (im[a] + im[b]), oi = -0.5f * (re[a] - re[b]);
+        float wr = (k < FFT_HALF) ? s->cosTable[k] : -1.0f;
+        float wi = (k < FFT_HALF) ? -s->sinTable[k] : 0.0f;
+        float xr = er + or_ * wr - oi * wi;
+        float xi = ei + or_ * wi + oi * wr;
+        power[k] = xr * xr + xi * xi;
+    }
+}
+
+// --- 起音包络 (每帧一个值，帧率 = rate / RR_BEAT_HOP) ---
+static void onsetEnvelope(const float* x, int n, std::vector<float>* env) {
+    FFTSetup s;                 // 约 12 KB，放栈上 (分析线程的栈足够)
+    initFFT(&s);
+
+    int frames = (n >= RR_BEAT_FRAME) ? (n - RR_BEAT_FRAME) / RR_BEAT_HOP + 1 : 0;
+    std::vector<float> flux(frames, 0.0f);
+    std::vector<float> prev(BEAT_BINS, 0.0f), cur(BEAT_BINS);
+    float power[BEAT_BINS];
+
+    for (int f = 0; f < frames; f++) {
+        powerSpectrum(&s, x + (long)f * RR_BEAT_HOP, power);
+
+        // 对数压缩让弱拍也有贡献，只累加能量增加的频点
+        float sum = 0;
+        for (int k = 0; k < BEAT_BINS; k++) {
+            cur[k] = logf(1.0f + 100.0f * sqrtf(power[k]));
+            float d = cur[k] - prev[k];
+            if (d > 0 && f > 0) sum += d;
+        }
+        flux[f] = sum;
+        prev.swap(cur);
+    }
+
+    // 减局部均值 (前缀和) 并半波整流
+    std::vector<double> prefix(frames + 1, 0.0);
+    for (int f = 0; f < frames; f++) prefix[f + 1] = prefix[f] + flux[f];
+    env->assign(frames, 0.0f);
+    for (int f = 0; f < frames; f++) {
+        int lo = f - BEAT_MEAN_WINDOW / 2, hi = f + BEAT_MEAN_WINDOW / 2 + 1;
+        if (lo < 0) lo = 0;
+        if (hi > frames) hi = frames;
+        float mean = (float)((prefix[hi] - prefix[lo]) / (hi - lo));
+        float v = flux[f] - mean;
+        (*env)[f] = v > 0 ? v : 0;
+    }
+}
+
+// --- 速度估计: 返回拍长 (帧，带小数)，找不到返回 0 ---
+static double estimatePeriod(const std::vector<float>& env, double frameRate) {
+    int frames = (int)env.size();
+    int minLag = (int)floor(frameRate * 60.0 / RR_BEAT_MAX_BPM);
+    int maxLag = (int)ceil(frameRate * 60.0 / RR_BEAT_MIN_BPM);
+    if (minLag < 1) minLag = 1;
+    if (maxLag + 1 >= frames) return 0;
+
+    std::vector<double> ac(maxLag + 2, 0.0);
+    for (int lag = minLag - 1; lag <= maxLag + 1; lag++) {
+        if (lag < 1) continue;
+        double sum = 0;
+        for (int f = lag; f < frames; f++) sum += (double)env[f] * env[f - lag];
+        ac[lag] = sum / (frames - lag);
+    }
+
+    // 对数高斯先验: 人听到的 "拍" 多在 120 BPM 附近，避免选成两倍或一半
+    // 真实拍长一般不是整数帧，峰值会分到相邻两个延迟上，打分时带上左右邻居
+    int best = 0;
+    double bestScore = 0;
+    for (int lag = minLag; lag <= maxLag; lag++) {
+        double bpm = frameRate * 60.0 / lag;
+        double octaves = log(bpm / BEAT_TEMPO_CENTER) / log(2.0);
+        double prior = exp(-0.5 * octaves * octaves / (BEAT_TEMPO_SPREAD * BEAT_TEMPO_SPREAD));
+        double score = (ac[lag - 1] + 2 * ac[lag] + ac[lag + 1]) * prior;
+        if (score > bestScore) {
+            bestScore = score;
+            best = lag;
+        }
+    }
+    if (best == 0) return 0;
+
+    // 抛物线插值得到小数拍长
+    double a = ac[best - 1], b = ac[best], c = ac[best + 1];
+    double denom = a - 2 * b + c;
+    double offset = (denom < 0) ? 0.5 * (a - c) / denom : 0;
+    if (offset < -0.5) offset = -0.5;
+    if (offset > 0.5) offset = 0.5;
+    return best + offset;
+}
+
+// --- 节拍跟踪: 动态规划 ---
+// score[f] = env[f] + max_p (score[p] - 惩罚(f - p 偏离拍长))，p 在 [f - 2T, f - T/2]
+static void trackBeats(const std::vector<float>& env, double period, std::vector<int>* beats) {
+    int frames = (int)env.size();
+    std::vector<double> score(frames);
+    std::vector<int> back(frames, -1);
+
+    // 包络归一化，惩罚系数才与音量无关
+    double mean = 0;
+    for (int f = 0; f < frames; f++) mean += env[f];
+    mean = (mean > 0) ? mean / frames : 1;
+
+    int minGap = (int)floor(period / 2);
+    int maxGap = (int)ceil(period * 2);
+    if (minGap < 1) minGap = 1;
+
+    // 惩罚只和间隔有关，预先算好
+    std::vector<double> penalty(maxGap + 1, 0.0);
+    for (int gap = minGap; gap <= maxGap; gap++) {
+        double r = log(gap / period);
+        penalty[gap] = BEAT_TIGHTNESS * r * r;
+    }
+
+    for (int f = 0; f < frames; f++) {
+        double local = env[f] / mean;
+        double bestPrev = 0;
+        int bestIndex = -1;
+        for (int gap = minGap; gap <= maxGap && gap <= f; gap++) {
+            double s = score[f - gap] - penalty[gap];
+            if (bestIndex < 0 || s > bestPrev) {
+                bestPrev = s;
+                bestIndex = f - gap;
+            }
+        }
+        // 接不上前面的拍 (或开头) 就从这里起头
+        if (bestIndex >= 0 && bestPrev > 0) {
+            score[f] = local + bestPrev;
+            back[f] = bestIndex;
+        } else {
+            score[f] = local;
+        }
+    }
+
+    // 从最后一拍长内得分最高的帧回溯
+    int last = frames - 1;
+    int from = frames - 1 - (int)ceil(period);
+    if (from < 0) from = 0;
+    for (int f = from; f < frames; f++) {
+        if (score[f] > score[last]) last = f;
+    }
+
+    beats->clear();
+    for (int f = last; f >= 0; f = back[f]) beats->push_back(f);
+    for (int i = 0, j = (int)beats->size() - 1; i < j; i++, j--) {
+        int t = (*beats)[i];
+        (*beats)[i] = (*beats)[j];
+        (*beats)[j] = t;
+    }
+}
+
+// --- 分析 ---
+int rrBeatAnalyze(const float* samples, int count, int rate, RRBeatMap* out) {
+    memset(out, 0, sizeof(RRBeatMap));
+    if (samples == NULL || count <= 0 || rate <= 0) return 0;
+
+    // 盒式平均降采样，节拍只看低频到中频的能量变化，够用
+    int factor = (rate + RR_BEAT_RATE - 1) / RR_BEAT_RATE;
+    int n = count / factor;
+    std::vector<float> x(n);
+    for (int i = 0; i < n; i++) {
+        float sum = 0;
+        for (int k = 0; k < factor; k++) sum += samples[i * factor + k];
+        x[i] = sum / factor;
+    }
+    double frameRate = (double)rate / factor / RR_BEAT_HOP;
+
+    out->duration = (float)count / rate;
+    out->frameRate = (float)frameRate;
+
+    // 响度包络: 每个帧移内的均方根 (原始精度足够画面和音频效果用)
+    out->frameCount = n / RR_BEAT_HOP;
+    if (out->frameCount > 0) {
+        out->loudness = (float*)malloc(sizeof(float) * out->frameCount);
+        if (out->loudness == NULL) return 0;
+        for (int f = 0; f < out->frameCount; f++) {
+            const float* p = &x[f * RR_BEAT_HOP];
+            float sum = 0;
+            for (int i = 0; i < RR_BEAT_HOP; i++) sum += p[i] * p[i];
+            out->loudness[f] = sqrtf(sum / RR_BEAT_HOP);
+        }
+    }
+
+    // 太短估不出速度的 (音效) 没有拍子，仍算成功
+    std::vector<float> env;
+    onsetEnvelope(x.data(), n, &env);
+    double period = estimatePeriod(env, frameRate);
+    if (period <= 0) return 1;
+
+    std::vector<int> frames;
+    trackBeats(env, period, &frames);
+    if (frames.empty()) return 1;
+
+    float peak = 0;
+    for (size_t i = 0; i < frames.size(); i++) {
+        if (env[frames[i]] > peak) peak = env[frames[i]];
+    }
+
+    out->beats = (float*)malloc(sizeof(float) * frames.size());
+    out->strength = (float*)malloc(sizeof(float) * frames.size());
+    if (out->beats == NULL || out->strength == NULL) {
+        rrBeatFree(out);
+        return 0;
+    }
+    out->bpm = (float)(frameRate * 60.0 / period);
+    out->beatCount = (int)frames.size();
+    // 帧的时刻取窗口中心
+    for (int i = 0; i < out->beatCount; i++) {
+        out->beats[i] = (float)((frames[i] + (double)RR_BEAT_FRAME / 2 / RR_BEAT_HOP) / frameRate);
+        out->strength[i] = (peak > 0) ? env[frames[i]] / peak : 0;
+    }
+    return 1;
+}
+
+int rrBeatAnalyzeFile(const char* path, RRBeatMap* out) {
+    float* samples;
+    int count, rate;
+    memset(out, 0, sizeof(RRBeatMap));
+    if (!rrBeatLoadWav(path, &samples, &count, &rate)) return 0;
+    int ok = rrBeatAnalyze(samples, count, rate, out);
+    free(samples);
+    return ok;
+}
+
+// --- 多首并行: 每个线程领一首 ---
+static void analyzeWorker(const char* const* paths, int n, RRBeatMap* out, int* ok, std::atomic<int>* next) {
+    for (;;) {
+        int i = next->fetch_add(1);
+        if (i >= n) break;
+        ok[i] = rrBeatAnalyzeFile(paths[i], &out[i]);
+    }
+}
+
+void rrBeatAnalyzeFiles(const char* const* paths, int n, RRBeatMap* out, int* ok, int threads) {
+    if (threads <= 0) threads = (int)std::thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+    if (threads > n) threads = n;
+
+    std::atomic<int> next(0);
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; i++) {
+        workers.push_back(std::thread(analyzeWorker, paths, n, out, ok, &next));
+    }
+    analyzeWorker(paths, n, out, ok, &next);
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+}
+
+void rrBeatFree(RRBeatMap* m) {
+    free(m->beats);
+    free(m->strength);
+    free(m->loudness);
+    m->beats = NULL;
+    m->strength = NULL;
+    m->loudness = NULL;
+    m->beatCount = 0;
+    m->frameCount = 0;
+}
+
+// --- 换算成模拟步数 ---
+int rrBeatToTicks(const RRBeatMap* m, int hz, int* ticks) {
+    int n = 0;
+    for (int i = 0; i < m->beatCount; i++) {
+        int tick = (int)(m->beats[i] * hz + 0.5f);
+        if (n > 0 && tick <= ticks[n - 1]) continue;
+        ticks[n++] = tick;
+    }
+    return n;
+}
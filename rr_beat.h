@@ -0,0 +1,42 @@
+/*
+ * 文件名: rr_beat.h
+ * 描述: 离线节拍分析: WAV 解码 -> 频谱通量起音检测 -> 速度估计 -> 节拍序列
+ *       结果给 rr_core 的障碍物生成用 (障碍物在拍子上到达恐龙)
+ *       不依赖 windows.h，游戏启动时或命令行 (rr_beat_tool) 都可以跑
+ */
+#ifndef RR_BEAT_H
+#define RR_BEAT_H
+
+// --- 分析参数 ---
+#define RR_BEAT_RATE 22050          // 分析前降采样到不高于这个频率
+#define RR_BEAT_FRAME 1024          // FFT 窗长
+#define RR_BEAT_HOP 256             // 帧移 (22050Hz 下约 11.6ms)
+#define RR_BEAT_MIN_BPM 60
+#define RR_BEAT_MAX_BPM 200
+
+// --- 一首曲子的节拍 ---
+typedef struct {
+    float bpm;              // 太短估不出速度时为 0 (此时没有拍子)
+    float duration;         // 曲子长度 (秒)
+    int beatCount;
+    float* beats;           // 每拍的时刻 (秒，升序)
+    float* strength;        // 每拍的起音强度 (0~1)
+    int frameCount;         // 响度包络的帧数
+    float frameRate;        // 响度包络每秒的帧数
+    float* loudness;        // 每帧的均方根响度 (0~1)
+} RRBeatMap;
+
+// --- WAV 解码 (PCM 8/16/24/32 位整数或 32 位浮点)，混成单声道，成功返回 1 ---
+int rrBeatLoadWav(const char* path, float** samples, int* count, int* rate);
+
+// --- 分析 (能解码就返回 1，out 用完要 rrBeatFree) ---
+int rrBeatAnalyze(const float* samples, int count, int rate, RRBeatMap* out);
+int rrBeatAnalyzeFile(const char* path, RRBeatMap* out);
+// 多首曲子并行分析 (每个线程一首)，ok[i] 为第 i 首是否成功，threads <= 0 时按 CPU 核数
+void rrBeatAnalyzeFiles(const char* const* paths, int n, RRBeatMap* out, int* ok, int threads);
+void rrBeatFree(RRBeatMap* m);
+
+// --- 换算成模拟步数 (去掉落在同一步的重复拍)，ticks 至少 beatCount 个，返回个数 ---
+int rrBeatToTicks(const RRBeatMap* m, int hz, int* ticks);
+
+#endif
@@ -0,0 +1,302 @@
+/*
+ * 文件名: rr_beat_cache.cpp
+ * 描述: 节拍分析缓存
+ *
+ * 缓存文件 <目录>/<哈希16位十六进制>.rrbm (小端，所有字段 4 字节对齐，可直接映射):
+ *   RRBeatFileHeader (56 字节)
+ *   beats[beatCount] strength[beatCount] loudness[frameCount] (float)
+ * 写入时先写 .tmp 再改名，其他进程不会映射到写了一半的文件
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "rr_beat_cache.h"
+
+#define CACHE_PATH_MAX 512
+
+// --- 缓存文件头 ---
+typedef struct {
+    char magic[4];              // RR_BEATMAP_MAGIC
+    uint32_t version;           // RR_BEATMAP_VERSION
+    uint64_t hash;              // WAV 内容哈希
+    uint32_t fileSize;
+    uint32_t beatCount;
+    uint32_t frameCount;
+    float bpm;
+    float duration;
+    float frameRate;
+    uint32_t beatsOffset;       // 各数组相对文件开头的字节偏移
+    uint32_t strengthOffset;
+    uint32_t loudnessOffset;
+    uint32_t reserved;
+} RRBeatFileHeader;
+
+// --- 缓存项 ---
+typedef struct {
+    std::atomic<int> state;     // RRBeatCacheState
+    char wavPath[CACHE_PATH_MAX];
+    RRMappedFile file;          // 映射的缓存文件
+    RRBeatMap map;              // 命中时指向映射内存，写回失败时是自己分配的
+    int owned;                  // map 需要 rrBeatFree
+} CacheEntry;
+
+struct RRBeatCache {
+    char dir[CACHE_PATH_MAX];
+    int count;
+    CacheEntry* entries;
+    std::atomic<int> next;
+    std::vector<std::thread> workers;
+};
+
+// --- 文件映射 ---
+int rrMapFile(const char* path, RRMappedFile* m) {
+    m->data = NULL;
+    m->size = 0;
+    m->handle = NULL;
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return 0;
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    }
+    CloseHandle(file);          // 映射对象自己持有文件
+    if (mapping == NULL) return 0;
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == NULL) {
+        CloseHandle(mapping);
+        return 0;
+    }
+    m->data = (const unsigned char*)view;
+    m->size = (size_t)size.QuadPart;
+    m->handle = mapping;
+    return 1;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (view == MAP_FAILED) return 0;
+    m->data = (const unsigned char*)view;
+    m->size = (size_t)st.st_size;
+    return 1;
+#endif
+}
+
+void rrUnmapFile(RRMappedFile* m) {
+    if (m->data == NULL) return;
+#if defined(_WIN32)
+    UnmapViewOfFile(m->data);
+    CloseHandle((HANDLE)m->handle);
+#else
+    munmap((void*)m->data, m->size);
+#endif
+    m->data = NULL;
+    m->size = 0;
+    m->handle = NULL;
+}
+
+// --- 内容哈希 ---
+uint64_t rrBeatHash(const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    uint64_t h = 0x243F6A8885A308D3ull ^ (uint64_t)size;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, 8);
+        h = (h ^ w) * 0x9E3779B97F4A7C15ull;
+        h ^= h >> 32;
+    }
+    for (; i < size; i++) {
+        h = (h ^ p[i]) * 0x100000001B3ull;
+    }
+    // splitmix64 的收尾，让低位也依赖所有输入位
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+    return h ^ (h >> 31);
+}
+
+static void cachePath(const RRBeatCache* c, uint64_t hash, char* out, size_t size) {
+    snprintf(out, size, "%s/%016llx.rrbm", c->dir, (unsigned long long)hash);
+}
+
+// --- 读: 只校验头部，数组直接指向映射 ---
+static int viewBeatFile(const RRMappedFile* f, uint64_t hash, RRBeatMap* out) {
+    if (f->size < sizeof(RRBeatFileHeader)) return 0;
+    const RRBeatFileHeader* h = (const RRBeatFileHeader*)f->data;
+    if (memcmp(h->magic, RR_BEATMAP_MAGIC, 4) != 0 || h->version != RR_BEATMAP_VERSION ||
+        h->hash != hash || h->fileSize != f->size) {
+        return 0;
+    }
+    // 偏移和长度都不能越过文件尾
+    uint64_t size = f->size;
+    if ((uint64_t)h->beatsOffset + 4ull * h->beatCount > size ||
+        (uint64_t)h->strengthOffset + 4ull * h->beatCount > size ||
+        (uint64_t)h->loudnessOffset + 4ull * h->frameCount > size ||
+        ((h->beatsOffset | h->strengthOffset | h->loudnessOffset) & 3) != 0) {
+        return 0;
+    }
+
+    out->bpm = h->bpm;
+    out->duration = h->duration;
+    out->beatCount = (int)h->beatCount;
+    out->beats = (float*)(f->data + h->beatsOffset);
+    out->strength = (float*)(f->data + h->strengthOffset);
+    out->frameCount = (int)h->frameCount;
+    out->frameRate = h->frameRate;
+    out->loudness = (float*)(f->data + h->loudnessOffset);
+    return 1;
+}
+
+// --- 写 ---
+static int writeBeatFile(const char* path, uint64_t hash, const RRBeatMap* m) {
+    RRBeatFileHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, RR_BEATMAP_MAGIC, 4);
+    h.version = RR_BEATMAP_VERSION;
+    h.hash = hash;
+    h.beatCount = (uint32_t)m->beatCount;
+    h.frameCount = (uint32_t)m->frameCount;
+    h.bpm = m->bpm;
+    h.duration = m->duration;
+    h.frameRate = m->frameRate;
+    h.beatsOffset = sizeof(RRBeatFileHeader);
+    h.strengthOffset = h.beatsOffset + 4 * h.beatCount;
+    h.loudnessOffset = h.strengthOffset + 4 * h.beatCount;
+    h.fileSize = h.loudnessOffset + 4 * h.frameCount;
+
+    char tmp[CACHE_PATH_MAX + 40];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE* fp = fopen(tmp, "wb");
+    if (fp == NULL) return 0;
+    int ok = fwrite(&h, sizeof(h), 1, fp) == 1 &&
+             fwrite(m->beats, 4, m->beatCount, fp) == (size_t)m->beatCount &&
+             fwrite(m->strength, 4, m->beatCount, fp) == (size_t)m->beatCount &&
+             fwrite(m->loudness, 4, m->frameCount, fp) == (size_t)m->frameCount;
+    ok &= (fclose(fp) == 0);
+
+#if defined(_WIN32)
+    ok = ok && MoveFileExA(tmp, path, MOVEFILE_REPLACE_EXISTING);
+#else
+    ok = ok && rename(tmp, path) == 0;
+#endif
+    if (!ok) remove(tmp);
+    return ok;
+}
+
+// --- 处理一项: 哈希 -> 映射缓存 -> 不行就分析并写回 ---
+static int loadEntry(RRBeatCache* c, CacheEntry* e) {
+    RRMappedFile wav;
+    if (!rrMapFile(e->wavPath, &wav)) return RR_BEAT_FAILED;
+    uint64_t hash = rrBeatHash(wav.data, wav.size);
+    rrUnmapFile(&wav);
+
+    char path[CACHE_PATH_MAX + 32];
+    cachePath(c, hash, path, sizeof(path));
+    if (rrMapFile(path, &e->file)) {
+        if (viewBeatFile(&e->file, hash, &e->map)) return RR_BEAT_MAPPED;
+        rrUnmapFile(&e->file);  // 过期或损坏，下面重写
+    }
+
+    RRBeatMap fresh;
+    if (!rrBeatAnalyzeFile(e->wavPath, &fresh)) return RR_BEAT_FAILED;
+
+    // 写回后改用映射，和命中缓存时一样；写不了 (只读目录等) 就直接用内存里的结果
+    if (writeBeatFile(path, hash, &fresh) && rrMapFile(path, &e->file)) {
+        if (viewBeatFile(&e->file, hash, &e->map)) {
+            rrBeatFree(&fresh);
+            return RR_BEAT_ANALYZED;
+        }
+        rrUnmapFile(&e->file);
+    }
+    e->map = fresh;
+    e->owned = 1;
+    return RR_BEAT_ANALYZED;
+}
+
+static void cacheWorker(RRBeatCache* c) {
+    for (;;) {
+        int i = c->next.fetch_add(1);
+        if (i >= c->count) break;
+        CacheEntry* e = &c->entries[i];
+        e->state.store(loadEntry(c, e), std::memory_order_release);
+    }
+}
+
+// --- 接口 ---
+RRBeatCache* rrBeatCacheOpen(const char* dir, const char* const* paths, int n, int threads) {
+    RRBeatCache* c = new RRBeatCache;
+    snprintf(c->dir, sizeof(c->dir), "%s", dir);
+    c->count = n;
+    c->entries = new CacheEntry[n > 0 ? n : 1];
+    c->next.store(0);
+    for (int i = 0; i < n; i++) {
+        CacheEntry* e = &c->entries[i];
+        e->state.store(RR_BEAT_PENDING);
+        snprintf(e->wavPath, sizeof(e->wavPath), "%s", paths[i]);
+        memset(&e->file, 0, sizeof(e->file));
+        memset(&e->map, 0, sizeof(e->map));
+        e->owned = 0;
+    }
+
+#if defined(_WIN32)
+    CreateDirectoryA(dir, NULL);
+#else
+    mkdir(dir, 0755);
+#endif
+
+    if (threads <= 0) threads = (int)std::thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+    if (threads > n) threads = n;
+    for (int i = 0; i < threads; i++) {
+        c->workers.push_back(std::thread(cacheWorker, c));
+    }
+    return c;
+}
+
+int rrBeatCacheState(const RRBeatCache* c, int i) {
+    if (i < 0 || i >= c->count) return RR_BEAT_FAILED;
+    return c->entries[i].state.load(std::memory_order_acquire);
+}
+
+const RRBeatMap* rrBeatCacheGet(const RRBeatCache* c, int i) {
+    return (rrBeatCacheState(c, i) > 0) ? &c->entries[i].map : NULL;
+}
+
+void rrBeatCacheWait(RRBeatCache* c) {
+    for (size_t i = 0; i < c->workers.size(); i++) {
+        c->workers[i].join();
+    }
+    c->workers.clear();
+}
+
+void rrBeatCacheClose(RRBeatCache* c) {
+    if (c == NULL) return;
+    rrBeatCacheWait(c);
+    for (int i = 0; i < c->count; i++) {
+        CacheEntry* e = &c->entries[i];
+        if (e->owned) rrBeatFree(&e->map);
+        rrUnmapFile(&e->file);
+    }
+    delete[] c->entries;
+    delete c;
+}
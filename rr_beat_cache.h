@@ -0,0 +1,50 @@
+/*
+ * 文件名: rr_beat_cache.h
+ * 描述: 节拍分析缓存: 每个 WAV 的分析结果存成一个 .rrbm 文件，文件名是 WAV 内容的哈希
+ *       下次启动直接内存映射，头部校验通过后数组指针指向映射内存，不做任何解析
+ *       缓存缺失或过期 (WAV 改了 / 分析版本变了) 时在后台线程重新分析，不阻塞菜单
+ */
+#ifndef RR_BEAT_CACHE_H
+#define RR_BEAT_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rr_beat.h"
+
+#define RR_BEATMAP_MAGIC "RRBM"
+#define RR_BEATMAP_VERSION 1       // 分析算法或文件格式变化时递增，旧缓存自动作废
+
+// --- 缓存项状态 ---
+typedef enum {
+    RR_BEAT_FAILED = -1,    // WAV 读不了
+    RR_BEAT_PENDING = 0,    // 后台还在处理
+    RR_BEAT_MAPPED = 1,     // 命中缓存，已映射
+    RR_BEAT_ANALYZED = 2    // 重新分析过 (并已写回缓存)
+} RRBeatCacheState;
+
+// --- 只读文件映射 ---
+typedef struct {
+    const unsigned char* data;
+    size_t size;
+    void* handle;           // Windows 的映射句柄 (POSIX 不用)
+} RRMappedFile;
+
+int rrMapFile(const char* path, RRMappedFile* m);   // 成功返回 1 (空文件算失败)
+void rrUnmapFile(RRMappedFile* m);
+
+// WAV 内容哈希 (64 位，每次处理 8 字节)
+uint64_t rrBeatHash(const void* data, size_t size);
+
+// --- 缓存 ---
+typedef struct RRBeatCache RRBeatCache;
+
+// 立即返回，后台 threads 个线程 (<= 0 时按 CPU 核数) 逐个查缓存或重新分析
+RRBeatCache* rrBeatCacheOpen(const char* dir, const char* const* paths, int n, int threads);
+int rrBeatCacheState(const RRBeatCache* c, int i);
+// 第 i 个文件的分析结果，还没好或失败返回 NULL (不阻塞)；结果归缓存所有，不要 rrBeatFree
+const RRBeatMap* rrBeatCacheGet(const RRBeatCache* c, int i);
+void rrBeatCacheWait(RRBeatCache* c);               // 等后台全部处理完
+void rrBeatCacheClose(RRBeatCache* c);              // 等后台结束并解除映射
+
+#endif
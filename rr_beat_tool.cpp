@@ -0,0 +1,91 @@
+/*
+ * 文件名: rr_beat_tool.cpp
+ * 描述: 节拍分析命令行工具，多首曲子并行分析，打印速度、拍数和耗时
+ *       可在构建时对 assets/AudioClip 下的曲目跑一遍，确认分析结果和速度
+ *       带 -c 时走缓存: 命中直接映射，缺失或过期的重新分析并写入缓存目录 (预先生成缓存)
+ * 编译: g++ -O2 -std=c++11 -pthread rr_beat_tool.cpp rr_beat.cpp rr_beat_cache.cpp -o rr_beat_tool
+ * 用法: rr_beat_tool [-c 缓存目录] 曲子1.wav [曲子2.wav ...]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include "rr_beat.h"
+#include "rr_beat_cache.h"
+
+#define PRINT_BEATS 8           // 每首打印的前几拍
+
+void printMap(const char* path, const RRBeatMap* m, const char* note) {
+    printf("%s: %.1f 秒, %.1f BPM, %d 拍%s\n", path, m->duration, m->bpm, m->beatCount, note);
+    if (m->beatCount == 0) return;
+    printf(" ");
+    for (int j = 0; j < m->beatCount && j < PRINT_BEATS; j++) {
+        printf(" %.3f(%.2f)", m->beats[j], m->strength[j]);
+    }
+    printf("%s\n", m->beatCount > PRINT_BEATS ? " ..." : "");
+}
+
+int main(int argc, char** argv) {
+    const char* cacheDir = NULL;
+    int first = 1;
+    if (argc > 2 && strcmp(argv[1], "-c") == 0) {
+        cacheDir = argv[2];
+        first = 3;
+    }
+    if (argc <= first) {
+        printf("用法: rr_beat_tool [-c 缓存目录] 曲子1.wav [曲子2.wav ...]\n");
+        return 1;
+    }
+
+    int n = argc - first;
+    const char* const* paths = (const char* const*)(argv + first);
+    int failed = 0;
+    double audio = 0;
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    if (cacheDir != NULL) {
+        RRBeatCache* cache = rrBeatCacheOpen(cacheDir, paths, n, 0);
+        rrBeatCacheWait(cache);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        int hits = 0;
+        for (int i = 0; i < n; i++) {
+            const RRBeatMap* m = rrBeatCacheGet(cache, i);
+            if (m == NULL) {
+                printf("%s: 无法分析\n", paths[i]);
+                failed++;
+                continue;
+            }
+            int hit = rrBeatCacheState(cache, i) == RR_BEAT_MAPPED;
+            hits += hit;
+            audio += m->duration;
+            printMap(paths[i], m, hit ? " (缓存)" : " (重新分析)");
+        }
+        rrBeatCacheClose(cache);
+        printf("共 %d 首, 命中缓存 %d 首, 音频 %.1f 秒, 用时 %.3f 秒\n", n, hits, audio, seconds);
+        return failed ? 2 : 0;
+    }
+
+    std::vector<RRBeatMap> maps(n);
+    std::vector<int> ok(n);
+    rrBeatAnalyzeFiles(paths, n, maps.data(), ok.data(), 0);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    for (int i = 0; i < n; i++) {
+        if (!ok[i]) {
+            printf("%s: 无法分析\n", paths[i]);
+            failed++;
+            continue;
+        }
+        audio += maps[i].duration;
+        printMap(paths[i], &maps[i], "");
+        rrBeatFree(&maps[i]);
+    }
+
+    printf("共 %d 首, 音频 %.1f 秒, 用时 %.3f 秒", n, audio, seconds);
+    if (seconds > 0) printf(" (实时的 %.0f 倍)", audio / seconds);
+    printf("\n");
+    return failed ? 2 : 0;
+}
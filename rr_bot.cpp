@@ -0,0 +1,119 @@
+/*
+ * 文件名: rr_bot.cpp
+ * 描述: 自动驾驶的前瞻搜索
+ *       每层对世界拷贝保持一个动作 RR_BOT_HOLD 步，先试 "跑"，死了再试 "跳"、"蹲"；
+ *       第一条活过 RR_BOT_HORIZON 步的计划立即采用。找不到时采用活得最久的那条，
+ *       并在每个动作结束时重新规划
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "rr_bot.h"
+
+// --- 一次规划的搜索状态 ---
+typedef struct {
+    int steps;                  // 已模拟步数 (预算)
+    int best;                   // 目前最长的存活步数
+    int bestLength;
+    int bestPlan[RR_BOT_DEPTH];
+    int current[RR_BOT_DEPTH];
+    RRWorld* worlds;            // 即 RRBot::worlds
+} Search;
+
+void rrBotInit(RRBot* b) {
+    b->worlds = (RRWorld*)malloc(sizeof(RRWorld) * RR_BOT_DEPTH);
+    rrBotReset(b);
+}
+
+void rrBotReset(RRBot* b) {
+    RRWorld* worlds = b->worlds;
+    memset(b, 0, sizeof(RRBot));
+    b->replanTicks = RR_BOT_HORIZON / 2;
+    b->worlds = worlds;
+}
+
+void rrBotFree(RRBot* b) {
+    free(b->worlds);
+    b->worlds = NULL;
+}
+
+// 对 w 保持动作 RR_BOT_HOLD 步，返回活过的步数
+static int holdAction(RRWorld* w, int action, Search* s) {
+    RRInput in;
+    for (int t = 0; t < RR_BOT_HOLD; t++) {
+        in.jump = (action == RR_BOT_JUMP && t == 0);
+        in.duck = (action == RR_BOT_DUCK);
+        rrStep(w, &in);
+        s->steps++;
+        if (w->gameOver) return t;
+    }
+    return RR_BOT_HOLD;
+}
+
+static void keepBest(Search* s, int alive, int length) {
+    if (alive <= s->best) return;
+    s->best = alive;
+    s->bestLength = length;
+    memcpy(s->bestPlan, s->current, sizeof(int) * length);
+}
+
+// 找到活过整个窗口的计划返回 1
+static int search(const RRWorld* w, int depth, int alive, Search* s) {
+    if (depth == RR_BOT_DEPTH) {
+        keepBest(s, alive, depth);
+        return 1;
+    }
+    for (int action = RR_BOT_RUN; action <= RR_BOT_DUCK; action++) {
+        if (action == RR_BOT_JUMP && w->dino.isJumping) continue;   // 空中按跳跃没有效果
+        if (s->steps >= RR_BOT_BUDGET) break;
+
+        RRWorld* next = &s->worlds[depth];
+        *next = *w;
+        s->current[depth] = action;
+        int lived = holdAction(next, action, s);
+        if (next->gameOver) {
+            keepBest(s, alive + lived, depth + 1);
+            continue;
+        }
+        if (search(next, depth + 1, alive + RR_BOT_HOLD, s)) return 1;
+    }
+    // 预算用完时没死的半截计划也算数
+    keepBest(s, alive, depth);
+    return 0;
+}
+
+static void replan(RRBot* b, const RRWorld* w) {
+    Search s;
+    s.steps = 0;
+    s.best = -1;
+    s.bestLength = 0;
+    s.worlds = b->worlds;
+
+    int ok = search(w, 0, 0, &s);
+    b->plans++;
+    b->simulatedSteps += s.steps;
+    if (!ok) b->failedPlans++;
+
+    memcpy(b->plan, s.bestPlan, sizeof(int) * s.bestLength);
+    b->planLength = s.bestLength;
+    b->planTick = w->frameCount;
+    // 没有活路的计划走完一个动作就重新找
+    b->replanTicks = ok ? RR_BOT_HORIZON / 2 : s.bestLength * RR_BOT_HOLD - RR_BOT_HOLD;
+}
+
+void rrBotInput(RRBot* b, const RRWorld* w, RRInput* out) {
+    if (b->worlds == NULL) {        // 没有搜索空间，一直跑
+        out->jump = 0;
+        out->duck = 0;
+        return;
+    }
+    int offset = w->frameCount - b->planTick;
+    if (b->planLength == 0 || offset < 0 || offset >= b->planLength * RR_BOT_HOLD - b->replanTicks) {
+        replan(b, w);
+        offset = 0;
+    }
+
+    int action = (b->planLength > 0) ? b->plan[offset / RR_BOT_HOLD] : RR_BOT_RUN;
+    out->jump = (action == RR_BOT_JUMP && offset % RR_BOT_HOLD == 0);
+    out->duck = (action == RR_BOT_DUCK);
+}
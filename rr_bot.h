@@ -0,0 +1,47 @@
+/*
+ * 文件名: rr_bot.h
+ * 描述: 自动驾驶: 拷贝当前世界，用 rrStep 本身向前模拟 (跳跃/重力/碰撞与游戏完全一致)，
+ *       深度优先搜索一串 "跑 / 跳 / 蹲" 动作，找一条能活过前瞻窗口的计划
+ *       世界是确定的 (生成随机数也在 RRWorld 里)，所以窗口内将要生成的障碍物也算在内
+ *       用于性能分析时产生长时间的稳定负载，以及检查改动后关卡是否仍然可通过
+ */
+#ifndef RR_BOT_H
+#define RR_BOT_H
+
+#include "rr_core.h"
+
+// --- 搜索参数 ---
+#define RR_BOT_HOLD 1           // 每个动作保持的步数 (搜索的粒度，逐步搜索才能踩准窄的起跳时机)
+#define RR_BOT_HORIZON 64       // 前瞻步数
+#define RR_BOT_DEPTH (RR_BOT_HORIZON / RR_BOT_HOLD)
+#define RR_BOT_BUDGET 20000     // 每次规划最多模拟的步数，找不到活路时按它截断
+
+// --- 动作 ---
+typedef enum {
+    RR_BOT_RUN = 0,         // 不按键
+    RR_BOT_JUMP = 1,        // 第一步按跳跃，之后不按
+    RR_BOT_DUCK = 2         // 一直按住下蹲
+} RRBotAction;
+
+typedef struct {
+    int plan[RR_BOT_DEPTH];     // 当前计划
+    int planLength;
+    int planTick;               // 计划第一个动作开始的步数
+    int replanTicks;            // 剩下不到这么多步就重新规划
+    RRWorld* worlds;            // 搜索每层的世界拷贝 (约 1 MB，rrBotInit 分配一次；NULL = 分配失败，只会跑)
+
+    // 统计
+    long long plans;            // 规划次数
+    long long simulatedSteps;   // 搜索中模拟的总步数
+    int failedPlans;            // 找不到能活过窗口的计划的次数
+} RRBot;
+
+// 分配搜索用的世界拷贝，用完要 rrBotFree
+void rrBotInit(RRBot* b);
+void rrBotFree(RRBot* b);
+// 重新开局: 清掉计划和统计，世界拷贝留着复用
+void rrBotReset(RRBot* b);
+// 在 rrStep 之前调用，给出这一步的输入
+void rrBotInput(RRBot* b, const RRWorld* w, RRInput* out);
+
+#endif
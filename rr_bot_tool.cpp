@@ -0,0 +1,71 @@
+/*
+ * 文件名: rr_bot_tool.cpp
+ * 描述: 自动驾驶命令行工具: 每个 角色 x 难度 组合让机器人跑若干局
+ *       有局在步数上限之前死亡说明关卡出现了无法通过的情况 (返回码 2)，可用作回归检查
+ * 编译: g++ -O2 -std=c++11 rr_bot_tool.cpp rr_bot.cpp rr_core.cpp rr_collide.cpp -o rr_bot_tool
+ * 用法: rr_bot_tool [每组局数=4] [每局最大步数=36000] [种子=1]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+#include "rr_bot.h"
+
+int main(int argc, char** argv) {
+    int runs = (argc > 1) ? atoi(argv[1]) : 4;
+    int maxSteps = (argc > 2) ? atoi(argv[2]) : 36000;
+    unsigned long long baseSeed = (argc > 3) ? strtoull(argv[3], NULL, 10) : 1;
+    if (runs <= 0 || maxSteps <= 0) {
+        printf("用法: rr_bot_tool [每组局数] [每局最大步数] [种子]\n");
+        return 1;
+    }
+
+    int deaths = 0;
+    long long totalSteps = 0, totalSearch = 0;
+    RRBot bot;
+    rrBotInit(&bot);                // 搜索空间只分配一次，每局 rrBotReset
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+    for (int ch = 0; ch < CHAR_COUNT; ch++) {
+        for (int lv = 0; lv < LEVEL_COUNT; lv++) {
+            long long scoreSum = 0;
+            int comboDeaths = 0, failedPlans = 0;
+
+            for (int run = 0; run < runs; run++) {
+                unsigned long long seed = baseSeed + (unsigned long long)((ch * LEVEL_COUNT + lv) * runs + run) * 2654435761u;
+                RRWorld world;
+                RRInput input;
+
+                rrInitWorld(&world, (CharacterType)ch, (DifficultyLevel)lv, seed);
+                rrBotReset(&bot);
+                while (!world.gameOver && world.frameCount < maxSteps) {
+                    rrBotInput(&bot, &world, &input);
+                    rrStep(&world, &input);
+                }
+
+                if (world.gameOver) {
+                    printf("  死亡: %s x %s 种子 %llu 第 %d 步 (%s)\n",
+                           charConfigs[ch].name, levelConfigs[lv].name, seed, world.frameCount,
+                           world.deathCause == 2 ? "飞鸟" : "仙人掌");
+                    comboDeaths++;
+                }
+                scoreSum += world.score;
+                failedPlans += bot.failedPlans;
+                totalSteps += world.frameCount;
+                totalSearch += bot.simulatedSteps;
+            }
+
+            printf("%s x %s: 存活 %d/%d, 平均分数 %.0f, 无解规划 %d 次\n",
+                   charConfigs[ch].name, levelConfigs[lv].name, runs - comboDeaths, runs,
+                   (double)scoreSum / runs, failedPlans);
+            deaths += comboDeaths;
+        }
+    }
+
+    rrBotFree(&bot);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    printf("共 %lld 步, 搜索模拟 %lld 步 (每步 %.1f), 用时 %.2f 秒, %.0f 步/秒\n",
+           totalSteps, totalSearch, (double)totalSearch / totalSteps, seconds, totalSteps / seconds);
+    return deaths ? 2 : 0;
+}
@@ -0,0 +1,39 @@
+/*
+ * 文件名: rr_collide.h
+ * 描述: 批量 AABB 重叠检测内核 (标量 / SSE2 / AVX2，运行时选择)
+ *       结果是位掩码: mask[i / 32] 的第 i % 32 位表示第 i 个盒子是否重叠
+ *       判定与 checkCollision 相同 (严格不等号)，各实现结果逐位一致
+ */
+#ifndef RR_COLLIDE_H
+#define RR_COLLIDE_H
+
+#include <stdint.h>
+
+#include "rr_core.h"
+
+#define RR_MASK_WORDS(n) (((n) + 31) / 32)
+
+// --- 按列存放的一组盒子 (直接指向 RRObstaclePool 的列) ---
+typedef struct {
+    const int* x;
+    const int* y;
+    const int* width;
+    const int* height;
+} RRBoxColumns;
+
+static inline RRBoxColumns rrPoolColumns(const RRObstaclePool* p) {
+    RRBoxColumns c = {p->x, p->y, p->width, p->height};
+    return c;
+}
+
+// 一个盒子 [x0, x1) x [y0, y1) 对 n 个盒子: 恐龙对所有障碍物，每条指令测 8 个
+void rrCollideQuery(int x0, int y0, int x1, int y1, const RRBoxColumns* boxes, int n, uint32_t* mask);
+
+// 转置形式: 第 i 对 a[i] 与 b[i]，用于多局同步推进的批量模拟 (每个通道一局，见 rr_balance)
+void rrCollideLanes(const RRBoxColumns* a, const RRBoxColumns* b, int n, uint32_t* mask);
+
+// --- 实现选择 ---
+int rrCollideLevel();                   // 当前使用的 RRSimdLevel
+int rrCollideSetLevel(int level);       // 强制指定 (超过 CPU 支持时取支持的最高级)，返回实际级别；非线程安全
+
+#endif
@@ -0,0 +1,151 @@
+/*
+ * 文件名: rr_collide_bench.cpp
+ * 描述: 碰撞内核微基准: 原 checkCollision 式的逐个判断 vs 标量 / SSE2 / AVX2 内核
+ *       同时校验各实现的掩码逐位一致
+ * 编译: g++ -O2 -std=c++11 rr_collide_bench.cpp rr_collide.cpp -o rr_collide_bench
+ * 用法: rr_collide_bench [盒子数=500] [重复次数=20000]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include "rr_collide.h"
+#include "rr_cpu.h"
+
+// --- 测试数据 (列存放) ---
+typedef struct {
+    std::vector<int> x, y, width, height;
+} BoxData;
+
+void makeBoxes(BoxData* d, int n, RRRng* rng) {
+    d->x.resize(n);
+    d->y.resize(n);
+    d->width.resize(n);
+    d->height.resize(n);
+    for (int i = 0; i < n; i++) {
+        // 与游戏里的障碍物尺寸、位置范围相近，命中率约一半，分支难以预测
+        d->x[i] = rrRngRange(rng, 240);
+        d->y[i] = GROUND_Y - 200 + rrRngRange(rng, 200);
+        d->width[i] = CACTUS_WIDTH + rrRngRange(rng, 20);
+        d->height[i] = BIRD_HEIGHT + rrRngRange(rng, 40);
+    }
+}
+
+RRBoxColumns columnsOf(const BoxData* d) {
+    RRBoxColumns c = {d->x.data(), d->y.data(), d->width.data(), d->height.data()};
+    return c;
+}
+
+volatile uint32_t sink;      // 防止计时循环被优化掉
+
+double secondsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int popcount(const uint32_t* mask, int words) {
+    int total = 0;
+    for (int i = 0; i < words; i++) {
+        for (uint32_t bits = mask[i]; bits != 0; bits &= bits - 1) total++;
+    }
+    return total;
+}
+
+void report(const char* name, double seconds, long long tests, int hits) {
+    printf("  %-22s %8.2f ns/个  %8.1f M个/秒  命中 %d\n",
+           name, seconds * 1e9 / tests, tests / seconds / 1e6, hits);
+}
+
+// --- 原 checkCollision 的写法: 逐个障碍物，四个比较加分支 ---
+void queryBranchy(int x0, int y0, int x1, int y1, const RRBoxColumns* b, int n, uint32_t* mask) {
+    memset(mask, 0, sizeof(uint32_t) * RR_MASK_WORDS(n));
+    for (int i = 0; i < n; i++) {
+        if (x0 < b->x[i] + b->width[i] &&
+            x1 > b->x[i] &&
+            y0 < b->y[i] + b->height[i] &&
+            y1 > b->y[i]) {
+            mask[i >> 5] |= 1u << (i & 31);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    int n = (argc > 1) ? atoi(argv[1]) : MAX_OBSTACLES_ON_SCREEN;
+    int repeat = (argc > 2) ? atoi(argv[2]) : 20000;
+    if (n <= 0 || repeat <= 0) {
+        printf("用法: rr_collide_bench [盒子数] [重复次数]\n");
+        return 1;
+    }
+
+    RRRng rng;
+    rrRngSeed(&rng, 1, RR_STREAM_SPAWN);
+    BoxData obstacles, dinos;
+    makeBoxes(&obstacles, n, &rng);
+    makeBoxes(&dinos, n, &rng);
+    RRBoxColumns obs = columnsOf(&obstacles);
+    RRBoxColumns lanesA = columnsOf(&dinos);
+
+    int words = RR_MASK_WORDS(n);
+    std::vector<uint32_t> expected(words), mask(words);
+    int dx0 = 100 - GAME_SPEED, dy0 = GROUND_Y - DINO_HEIGHT;
+    int dx1 = 100 + DINO_WIDTH, dy1 = GROUND_Y;
+    int best = rrCpuSimdLevel();
+    int ok = 1;
+
+    printf("CPU 支持: %s   %d 个盒子 x %d 次\n", rrSimdName(best), n, repeat);
+
+    // --- 一个恐龙对所有障碍物 ---
+    printf("单查询 (恐龙 vs 障碍物):\n");
+    queryBranchy(dx0, dy0, dx1, dy1, &obs, n, expected.data());
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeat; r++) {
+        queryBranchy(dx0, dy0 + (r & 7), dx1, dy1, &obs, n, mask.data());
+        sink ^= mask[0];
+    }
+    report("逐个判断 (原写法)", secondsSince(t0), (long long)n * repeat, popcount(mask.data(), words));
+
+    for (int level = RR_SIMD_SCALAR; level <= best; level++) {
+        rrCollideSetLevel(level);
+        rrCollideQuery(dx0, dy0, dx1, dy1, &obs, n, mask.data());
+        if (memcmp(mask.data(), expected.data(), sizeof(uint32_t) * words) != 0) {
+            printf("  %s: 结果不一致!\n", rrSimdName(level));
+            ok = 0;
+        }
+
+        t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeat; r++) {
+            rrCollideQuery(dx0, dy0 + (r & 7), dx1, dy1, &obs, n, mask.data());
+            sink ^= mask[0];
+        }
+        report(rrSimdName(level), secondsSince(t0), (long long)n * repeat, popcount(mask.data(), words));
+    }
+
+    // --- 转置: 每个通道一局，各自的恐龙对各自的障碍物 ---
+    printf("转置 (%d 局同步):\n", n);
+    memset(expected.data(), 0, sizeof(uint32_t) * words);
+    for (int i = 0; i < n; i++) {
+        if (lanesA.x[i] < obs.x[i] + obs.width[i] && lanesA.x[i] + lanesA.width[i] > obs.x[i] &&
+            lanesA.y[i] < obs.y[i] + obs.height[i] && lanesA.y[i] + lanesA.height[i] > obs.y[i]) {
+            expected[i >> 5] |= 1u << (i & 31);
+        }
+    }
+    for (int level = RR_SIMD_SCALAR; level <= best; level++) {
+        rrCollideSetLevel(level);
+        rrCollideLanes(&lanesA, &obs, n, mask.data());
+        if (memcmp(mask.data(), expected.data(), sizeof(uint32_t) * words) != 0) {
+            printf("  %s: 结果不一致!\n", rrSimdName(level));
+            ok = 0;
+        }
+
+        t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeat; r++) {
+            rrCollideLanes(&lanesA, &obs, n, mask.data());
+            sink ^= mask[0];
+        }
+        report(rrSimdName(level), secondsSince(t0), (long long)n * repeat, popcount(mask.data(), words));
+    }
+
+    printf("校验: %s\n", ok ? "一致" : "不一致!");
+    return ok ? 0 : 2;
+}
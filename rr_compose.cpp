@@ -0,0 +1,568 @@
+/*
+ * 文件名: rr_compose.cpp
+ * 描述: 脏矩形合成器
+ *       记录: 每个图元算好外接框和哈希存进本帧列表
+ *       比较: 两帧的 (哈希, 下标) 各自排序后归并，哈希相同再逐字段比较确认，
+ *             没配上的图元和相对顺序变了的图元把外接框标进损坏方块表，再按行连成脏矩形；
+ *             估算下来逐个矩形重放不比整屏重画便宜时整屏重画
+ *       重放: 逐个脏矩形设置裁剪，按原顺序重放与它相交的图元
+ *       图层: 画图层期间照常记录，结束时把这一段整体重放进后端的图层再从列表里截掉
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "rr_compose.h"
+
+// --- 图元类型 ---
+enum {
+    CMD_CLEAR,
+    CMD_SOLID_RECT,
+    CMD_RECT,
+    CMD_SOLID_ELLIPSE,
+    CMD_ELLIPSE,
+    CMD_SOLID_CIRCLE,
+    CMD_POLYGON,
+    CMD_LINE,
+    CMD_TEXT,
+    CMD_CLIP,
+    CMD_LAYER
+};
+
+// --- 矩形 ---
+static long long rectArea(RRRect r) {
+    return rrRectEmpty(r) ? 0 : (long long)(r.right - r.left + 1) * (r.bottom - r.top + 1);
+}
+
+static RRRect screenRect(const RRCompositor* c) {
+    RRRect r = {0, 0, c->target->width - 1, c->target->height - 1};
+    return r;
+}
+
+// --- 损坏区域 ---
+// 先在方块表里标记，全部标完再连成矩形: 分散的小图元 (星星) 各占一两个方块，不会被并成大矩形
+static void addDamage(RRCompositor* c, RRRect r) {
+    r = rrRectIntersect(r, screenRect(c));
+    if (rrRectEmpty(r)) return;
+    int x0 = r.left / RR_DAMAGE_TILE, x1 = r.right / RR_DAMAGE_TILE;
+    for (int y = r.top / RR_DAMAGE_TILE; y <= r.bottom / RR_DAMAGE_TILE; y++) {
+        memset(c->tiles + y * c->tileCols + x0, 1, x1 - x0 + 1);
+    }
+}
+
+// 每行连续的脏方块是一段，和上一行左右端相同的段接成一个矩形；矩形太多返回 0
+static int buildDamageRects(RRCompositor* c) {
+    RRRect screen = screenRect(c);
+    int prevStart = 0, rowStart = 0;       // 上一行和本行的矩形在 damage 里的起点
+    c->damageCount = 0;
+    for (int y = 0; y < c->tileRows; y++) {
+        const unsigned char* row = c->tiles + y * c->tileCols;
+        for (int x = 0; x < c->tileCols; x++) {
+            if (!row[x]) continue;
+            int end = x;
+            while (end + 1 < c->tileCols && row[end + 1]) end++;
+            RRRect r = rrRectIntersect(rrRectMake(x * RR_DAMAGE_TILE, y * RR_DAMAGE_TILE,
+                                                  end * RR_DAMAGE_TILE + RR_DAMAGE_TILE - 1,
+                                                  y * RR_DAMAGE_TILE + RR_DAMAGE_TILE - 1), screen);
+            int k = prevStart;
+            while (k < rowStart && (c->damage[k].left != r.left || c->damage[k].right != r.right)) k++;
+            if (k < rowStart) {
+                // 接上的矩形和上一行的最后一个交换，归到本行，下一行还能接着往下长
+                RRRect grown = c->damage[k];
+                grown.bottom = r.bottom;
+                c->damage[k] = c->damage[rowStart - 1];
+                c->damage[rowStart - 1] = grown;
+                rowStart--;
+            } else {
+                if (c->damageCount == RR_DAMAGE_MAX_RECTS) return 0;
+                c->damage[c->damageCount++] = r;
+            }
+            x = end;
+        }
+        prevStart = rowStart;
+        rowStart = c->damageCount;
+    }
+    return 1;
+}
+
+// 方块表按目标当前的大小分配 (目标改了大小时重新分配)
+static int reserveTiles(RRCompositor* c) {
+    int cols = (c->target->width + RR_DAMAGE_TILE - 1) / RR_DAMAGE_TILE;
+    int rows = (c->target->height + RR_DAMAGE_TILE - 1) / RR_DAMAGE_TILE;
+    if (c->tiles != NULL && cols == c->tileCols && rows == c->tileRows) return 1;
+    free(c->tiles);
+    c->tiles = (unsigned char*)malloc((size_t)cols * rows);
+    c->tileCols = cols;
+    c->tileRows = rows;
+    return c->tiles != NULL;
+}
+
+static void damageAll(RRCompositor* c) {
+    c->damage[0] = screenRect(c);
+    c->damageCount = 1;
+}
+
+// --- 绘制列表 ---
+static RRDrawCmd* pushCmd(RRCompositor* c, int op) {
+    RRDrawList* l = &c->lists[c->current];
+    if (l->count == l->capacity) {
+        int capacity = l->capacity ? l->capacity * 2 : 256;
+        RRDrawCmd* cmds = (RRDrawCmd*)realloc(l->cmds, sizeof(RRDrawCmd) * capacity);
+        if (cmds == NULL) return NULL;
+        l->cmds = cmds;
+        l->capacity = capacity;
+    }
+    RRDrawCmd* cmd = &l->cmds[l->count++];
+    memset(cmd, 0, sizeof(RRDrawCmd));
+    cmd->op = op;
+    cmd->data = -1;
+    return cmd;
+}
+
+// 附带数据 (文字 / 顶点) 追加到列表，返回偏移，失败返回 -1
+static int pushData(RRCompositor* c, const void* data, int size) {
+    RRDrawList* l = &c->lists[c->current];
+    if (l->dataSize + size > l->dataCapacity) {
+        int capacity = l->dataCapacity ? l->dataCapacity * 2 : 4096;
+        while (capacity < l->dataSize + size) capacity *= 2;
+        char* buffer = (char*)realloc(l->data, capacity);
+        if (buffer == NULL) return -1;
+        l->data = buffer;
+        l->dataCapacity = capacity;
+    }
+    int offset = l->dataSize;
+    memcpy(l->data + offset, data, size);
+    l->dataSize += size;
+    return offset;
+}
+
+static int dataSize(const RRDrawCmd* cmd, const RRDrawList* l) {
+    if (cmd->data < 0) return 0;
+    if (cmd->op == CMD_POLYGON) return cmd->count * (int)sizeof(RRPoint);
+    return (int)strlen(l->data + cmd->data) + 1;
+}
+
+static uint32_t hashBytes(uint32_t h, const void* p, int size) {
+    const unsigned char* b = (const unsigned char*)p;
+    for (int i = 0; i < size; i++) h = (h ^ b[i]) * 16777619u;
+    return h;
+}
+
+// 算外接框 (裁到当前裁剪框) 和哈希
+static void finishCmd(RRCompositor* c, RRDrawCmd* cmd, RRRect bounds) {
+    const RRDrawList* l = &c->lists[c->current];
+    cmd->bounds = (cmd->op == CMD_CLIP) ? bounds : rrRectIntersect(bounds, c->recordClip);
+
+    uint32_t h = 2166136261u;
+    int fields[8] = {cmd->op, cmd->a, cmd->b, cmd->c, cmd->d, (int)cmd->color, cmd->textHeight, cmd->count};
+    h = hashBytes(h, fields, sizeof(fields));
+    if (cmd->layer != NULL) h = hashBytes(h, &cmd->layer, sizeof(cmd->layer));
+    if (cmd->data >= 0) h = hashBytes(h, l->data + cmd->data, dataSize(cmd, l));
+    cmd->hash = h;
+}
+
+static int cmdEqual(const RRDrawCmd* x, const RRDrawList* lx, const RRDrawCmd* y, const RRDrawList* ly) {
+    if (x->op != y->op || x->a != y->a || x->b != y->b || x->c != y->c || x->d != y->d ||
+        x->color != y->color || x->textHeight != y->textHeight || x->count != y->count || x->layer != y->layer) {
+        return 0;
+    }
+    int size = dataSize(x, lx);
+    if (size != dataSize(y, ly)) return 0;
+    return size == 0 || memcmp(lx->data + x->data, ly->data + y->data, size) == 0;
+}
+
+// --- 记录用的后端函数 ---
+static void recordBox(RRCompositor* c, int op, int left, int top, int right, int bottom, RRColor color) {
+    RRDrawCmd* cmd = pushCmd(c, op);
+    if (cmd == NULL) return;
+    cmd->a = left;
+    cmd->b = top;
+    cmd->c = right;
+    cmd->d = bottom;
+    cmd->color = color;
+    finishCmd(c, cmd, rrRectMake(left, top, right, bottom));
+}
+
+static void composeClear(void* impl, RRColor color) {
+    RRCompositor* c = (RRCompositor*)impl;
+    RRRect s = screenRect(c);
+    recordBox(c, CMD_CLEAR, s.left, s.top, s.right, s.bottom, color);
+}
+
+static void composeSolidRect(void* impl, int left, int top, int right, int bottom, RRColor color) {
+    recordBox((RRCompositor*)impl, CMD_SOLID_RECT, left, top, right, bottom, color);
+}
+
+static void composeRect(void* impl, int left, int top, int right, int bottom, RRColor color) {
+    recordBox((RRCompositor*)impl, CMD_RECT, left, top, right, bottom, color);
+}
+
+static void composeSolidEllipse(void* impl, int left, int top, int right, int bottom, RRColor color) {
+    recordBox((RRCompositor*)impl, CMD_SOLID_ELLIPSE, left, top, right, bottom, color);
+}
+
+static void composeEllipse(void* impl, int left, int top, int right, int bottom, RRColor color) {
+    recordBox((RRCompositor*)impl, CMD_ELLIPSE, left, top, right, bottom, color);
+}
+
+static void composeSolidCircle(void* impl, int x, int y, int radius, RRColor color) {
+    RRCompositor* c = (RRCompositor*)impl;
+    RRDrawCmd* cmd = pushCmd(c, CMD_SOLID_CIRCLE);
+    if (cmd == NULL) return;
+    cmd->a = x;
+    cmd->b = y;
+    cmd->c = radius;
+    cmd->color = color;
+    finishCmd(c, cmd, rrRectMake(x - radius, y - radius, x + radius, y + radius));
+}
+
+static void composeSolidPolygon(void* impl, const RRPoint* points, int count, RRColor color) {
+    RRCompositor* c = (RRCompositor*)impl;
+    if (count <= 0) return;
+    RRDrawCmd* cmd = pushCmd(c, CMD_POLYGON);
+    if (cmd == NULL) return;
+    cmd->color = color;
+    cmd->count = count;
+    cmd->data = pushData(c, points, count * (int)sizeof(RRPoint));
+    RRRect bounds = rrRectMake(points[0].x, points[0].y, points[0].x, points[0].y);
+    for (int i = 1; i < count; i++) {
+        bounds = rrRectUnion(bounds, rrRectMake(points[i].x, points[i].y, points[i].x, points[i].y));
+    }
+    finishCmd(c, cmd, bounds);
+}
+
+static void composeLine(void* impl, int x1, int y1, int x2, int y2, RRColor color) {
+    recordBox((RRCompositor*)impl, CMD_LINE, x1, y1, x2, y2, color);
+}
+
+static int composeTextWidth(void* impl, const char* text, int height) {
+    RRCompositor* c = (RRCompositor*)impl;
+    return c->target->ops->textWidth(c->target->impl, text, height);
+}
+
+static void composeText(void* impl, int x, int y, const char* text, int height, RRColor color) {
+    RRCompositor* c = (RRCompositor*)impl;
+    int width = composeTextWidth(impl, text, height);
+    RRDrawCmd* cmd = pushCmd(c, CMD_TEXT);
+    if (cmd == NULL) return;
+    cmd->a = x;
+    cmd->b = y;
+    cmd->color = color;
+    cmd->textHeight = height;
+    cmd->data = pushData(c, text, (int)strlen(text) + 1);
+    finishCmd(c, cmd, rrRectMake(x, y, x + width - 1, y + height - 1));
+}
+
+static void composeSetClip(void* impl, int left, int top, int right, int bottom) {
+    RRCompositor* c = (RRCompositor*)impl;
+    c->recordClip = rrRectIntersect(rrRectMake(left, top, right, bottom), screenRect(c));
+    recordBox(c, CMD_CLIP, left, top, right, bottom, 0);
+}
+
+// --- 比较两帧 ---
+// 按高 32 位 (哈希) 逐字节做 4 趟基数排序，tmp 至少 n 个
+// 每趟都是稳定的，低 32 位 (下标) 本来递增，排完整个键有序；比 qsort 少了每次比较的函数调用
+static void sortKeys(uint64_t* keys, uint64_t* tmp, int n) {
+    for (int shift = 32; shift < 64; shift += 8) {
+        int start[257] = {0};
+        for (int i = 0; i < n; i++) start[((keys[i] >> shift) & 0xFF) + 1]++;
+        for (int b = 0; b < 256; b++) start[b + 1] += start[b];
+        for (int i = 0; i < n; i++) tmp[start[(keys[i] >> shift) & 0xFF]++] = keys[i];
+        uint64_t* swap = keys;
+        keys = tmp;
+        tmp = swap;
+    }
+}
+
+static int reserveScratch(RRCompositor* c, size_t size) {
+    if (size <= c->scratchSize) return 1;
+    void* p = realloc(c->scratch, size);
+    if (p == NULL) return 0;
+    c->scratch = p;
+    c->scratchSize = size;
+    return 1;
+}
+
+static void collectDamage(RRCompositor* c) {
+    const RRDrawList* cur = &c->lists[c->current];
+    const RRDrawList* prev = &c->lists[!c->current];
+
+    int most = (cur->count > prev->count) ? cur->count : prev->count;
+    size_t need = sizeof(uint64_t) * (cur->count + prev->count + most) + sizeof(int) * cur->count + prev->count;
+    if (c->fullRepaint || !reserveTiles(c) || !reserveScratch(c, need)) {
+        damageAll(c);
+        c->fullRepaint = 0;
+        return;
+    }
+    memset(c->tiles, 0, (size_t)c->tileCols * c->tileRows);
+
+    // (哈希 << 32 | 下标) 排序后，相同哈希的一组按下标从小到大
+    uint64_t* curKeys = (uint64_t*)c->scratch;
+    uint64_t* prevKeys = curKeys + cur->count;
+    uint64_t* sortTemp = prevKeys + prev->count;
+    int* matchOf = (int*)(sortTemp + most);             // 本帧图元对应上一帧的下标，-1 = 没有
+    char* prevUsed = (char*)(matchOf + cur->count);
+    for (int i = 0; i < cur->count; i++) {
+        curKeys[i] = ((uint64_t)cur->cmds[i].hash << 32) | (uint32_t)i;
+        matchOf[i] = -1;
+    }
+    for (int j = 0; j < prev->count; j++) {
+        prevKeys[j] = ((uint64_t)prev->cmds[j].hash << 32) | (uint32_t)j;
+        prevUsed[j] = 0;
+    }
+    sortKeys(curKeys, sortTemp, cur->count);
+    sortKeys(prevKeys, sortTemp, prev->count);
+
+    int i = 0, j = 0;
+    while (i < cur->count && j < prev->count) {
+        uint32_t hi = (uint32_t)(curKeys[i] >> 32), hj = (uint32_t)(prevKeys[j] >> 32);
+        if (hi < hj) {
+            i++;
+        } else if (hi > hj) {
+            j++;
+        } else {
+            // 同一个哈希的两组，逐个找内容真正相同的配对
+            int iEnd = i, jEnd = j;
+            while (iEnd < cur->count && (uint32_t)(curKeys[iEnd] >> 32) == hi) iEnd++;
+            while (jEnd < prev->count && (uint32_t)(prevKeys[jEnd] >> 32) == hi) jEnd++;
+            for (int a = i; a < iEnd; a++) {
+                int ci = (int)(uint32_t)curKeys[a];
+                for (int b = j; b < jEnd; b++) {
+                    int pj = (int)(uint32_t)prevKeys[b];
+                    if (!prevUsed[pj] && cmdEqual(&cur->cmds[ci], cur, &prev->cmds[pj], prev)) {
+                        prevUsed[pj] = 1;
+                        matchOf[ci] = pj;
+                        break;
+                    }
+                }
+            }
+            i = iEnd;
+            j = jEnd;
+        }
+    }
+
+    // 本帧新的，以及配上了但排到了前面某个元素之前的 (前后遮挡关系变了)
+    int maxPrev = -1;
+    for (int k = 0; k < cur->count; k++) {
+        if (matchOf[k] < 0 || matchOf[k] < maxPrev) {
+            addDamage(c, cur->cmds[k].bounds);
+        } else {
+            maxPrev = matchOf[k];
+        }
+    }
+    // 上一帧有、这一帧没了的
+    for (int k = 0; k < prev->count; k++) {
+        if (!prevUsed[k]) addDamage(c, prev->cmds[k].bounds);
+    }
+
+    // 逐个矩形重放比整屏重画还贵就整屏重画
+    if (!buildDamageRects(c)) {
+        damageAll(c);
+        return;
+    }
+    long long cost = (long long)c->damageCount * RR_DAMAGE_RECT_COST;
+    for (int k = 0; k < c->damageCount; k++) cost += rectArea(c->damage[k]);
+    if (cost * 100 > rectArea(screenRect(c)) * RR_DAMAGE_FULL_PERCENT) damageAll(c);
+}
+
+// --- 重放 ---
+static void replayCmd(RRRenderer* t, const RRDrawCmd* cmd, const RRDrawList* l) {
+    switch (cmd->op) {
+        case CMD_CLEAR:
+            t->ops->clear(t->impl, cmd->color);
+            break;
+        case CMD_SOLID_RECT:
+            t->ops->solidRect(t->impl, cmd->a, cmd->b, cmd->c, cmd->d, cmd->color);
+            break;
+        case CMD_RECT:
+            t->ops->rect(t->impl, cmd->a, cmd->b, cmd->c, cmd->d, cmd->color);
+            break;
+        case CMD_SOLID_ELLIPSE:
+            t->ops->solidEllipse(t->impl, cmd->a, cmd->b, cmd->c, cmd->d, cmd->color);
+            break;
+        case CMD_ELLIPSE:
+            t->ops->ellipse(t->impl, cmd->a, cmd->b, cmd->c, cmd->d, cmd->color);
+            break;
+        case CMD_SOLID_CIRCLE:
+            t->ops->solidCircle(t->impl, cmd->a, cmd->b, cmd->c, cmd->color);
+            break;
+        case CMD_POLYGON:
+            if (cmd->data >= 0) t->ops->solidPolygon(t->impl, (const RRPoint*)(l->data + cmd->data), cmd->count, cmd->color);
+            break;
+        case CMD_LINE:
+            t->ops->line(t->impl, cmd->a, cmd->b, cmd->c, cmd->d, cmd->color);
+            break;
+        case CMD_TEXT:
+            if (cmd->data >= 0) t->ops->text(t->impl, cmd->a, cmd->b, l->data + cmd->data, cmd->textHeight, cmd->color);
+            break;
+        case CMD_LAYER:
+            t->ops->drawLayer(t->impl, cmd->layer, cmd->a, cmd->b, cmd->c, cmd->d);
+            break;
+    }
+}
+
+// --- 图层 ---
+static void* composeCreateLayer(void* impl, int width, int height) {
+    RRCompositor* c = (RRCompositor*)impl;
+    return c->target->ops->createLayer(c->target->impl, width, height);
+}
+
+static void composeFreeLayer(void* impl, void* layer) {
+    RRCompositor* c = (RRCompositor*)impl;
+    for (int i = 0; i < c->layerCount; i++) {
+        if (c->layers[i] == layer) {
+            c->layerCount--;
+            c->layers[i] = c->layers[c->layerCount];
+            c->versions[i] = c->versions[c->layerCount];
+            break;
+        }
+    }
+    c->target->ops->freeLayer(c->target->impl, layer);
+}
+
+// 图层的版本表: 找不到 (没经过合成器画过、或被挤掉了) 就当作刚重画，给一个新版本
+static int* layerVersionOf(RRCompositor* c, void* layer) {
+    for (int i = 0; i < c->layerCount; i++) {
+        if (c->layers[i] == layer) return &c->versions[i];
+    }
+    int i = c->layerCount;
+    if (i < RR_COMPOSE_LAYERS) {
+        c->layerCount++;
+    } else {
+        i = c->layerEvict;
+        c->layerEvict = (c->layerEvict + 1) % RR_COMPOSE_LAYERS;
+    }
+    c->layers[i] = layer;
+    c->versions[i] = ++c->layerVersion;
+    return &c->versions[i];
+}
+
+// 把记下的图层内容整段画进后端的图层，再从本帧列表里去掉
+static void finishLayer(RRCompositor* c) {
+    RRRenderer* t = c->target;
+    RRDrawList* l = &c->lists[c->current];
+    t->ops->beginLayer(t->impl, c->building);
+    for (int i = c->layerStart; i < l->count; i++) {
+        const RRDrawCmd* cmd = &l->cmds[i];
+        if (cmd->op == CMD_CLIP) {
+            t->ops->setClip(t->impl, cmd->bounds.left, cmd->bounds.top, cmd->bounds.right, cmd->bounds.bottom);
+        } else {
+            replayCmd(t, cmd, l);
+        }
+    }
+    t->ops->beginLayer(t->impl, NULL);
+    l->count = c->layerStart;
+    l->dataSize = c->layerDataStart;
+    *layerVersionOf(c, c->building) = ++c->layerVersion;
+    c->building = NULL;
+    c->recordClip = screenRect(c);
+}
+
+static void composeBeginLayer(void* impl, void* layer) {
+    RRCompositor* c = (RRCompositor*)impl;
+    if (c->building != NULL) finishLayer(c);
+    if (layer != NULL) {
+        c->building = layer;
+        c->layerStart = c->lists[c->current].count;
+        c->layerDataStart = c->lists[c->current].dataSize;
+    }
+}
+
+static void composeDrawLayer(void* impl, void* layer, int x, int y, int width, int height) {
+    RRCompositor* c = (RRCompositor*)impl;
+    RRDrawCmd* cmd = pushCmd(c, CMD_LAYER);
+    if (cmd == NULL) return;
+    cmd->a = x;
+    cmd->b = y;
+    cmd->c = width;
+    cmd->d = height;
+    cmd->count = *layerVersionOf(c, layer);
+    cmd->layer = layer;
+    finishCmd(c, cmd, rrRectMake(x, y, x + width - 1, y + height - 1));
+}
+
+static void composePresent(void* impl) {
+    RRCompositor* c = (RRCompositor*)impl;
+    RRRenderer* t = c->target;
+    const RRDrawList* cur = &c->lists[c->current];
+
+    if (c->building != NULL) finishLayer(c);    // 画面代码忘了结束图层
+    collectDamage(c);
+
+    long long pixels = 0;
+    for (int k = 0; k < c->damageCount; k++) {
+        RRRect dirty = c->damage[k];
+        RRRect clip = screenRect(c);
+        RRRect active = dirty;
+        pixels += rectArea(dirty);
+        t->ops->setClip(t->impl, active.left, active.top, active.right, active.bottom);
+        for (int i = 0; i < cur->count; i++) {
+            const RRDrawCmd* cmd = &cur->cmds[i];
+            if (cmd->op == CMD_CLIP) {
+                clip = cmd->bounds;
+                active = rrRectIntersect(clip, dirty);
+                if (!rrRectEmpty(active)) t->ops->setClip(t->impl, active.left, active.top, active.right, active.bottom);
+                continue;
+            }
+            if (rrRectEmpty(active)) continue;
+            RRRect hit = rrRectIntersect(cmd->bounds, active);
+            if (!rrRectEmpty(hit)) replayCmd(t, cmd, cur);
+        }
+    }
+    t->ops->setClip(t->impl, 0, 0, t->width - 1, t->height - 1);
+    t->ops->present(t->impl);
+
+    c->lastCmds = cur->count;
+    c->lastDamageRects = c->damageCount;
+    c->lastDamagePixels = pixels;
+
+    // 本帧变成上一帧，新的一帧从空列表开始
+    c->current = !c->current;
+    c->lists[c->current].count = 0;
+    c->lists[c->current].dataSize = 0;
+    c->recordClip = screenRect(c);
+}
+
+static const RRRenderOps composeOps = {
+    composeClear,
+    composeSolidRect,
+    composeRect,
+    composeSolidEllipse,
+    composeEllipse,
+    composeSolidCircle,
+    composeSolidPolygon,
+    composeLine,
+    composeText,
+    composeTextWidth,
+    composeSetClip,
+    composeCreateLayer,
+    composeFreeLayer,
+    composeBeginLayer,
+    composeDrawLayer,
+    composePresent
+};
+
+void rrCompositorInit(RRRenderer* r, RRCompositor* c, RRRenderer* target) {
+    memset(c, 0, sizeof(RRCompositor));
+    c->target = target;
+    c->fullRepaint = 1;
+    c->recordClip = screenRect(c);
+    rrRendererInit(r, &composeOps, c, target->width, target->height);
+}
+
+void rrCompositorFree(RRCompositor* c) {
+    for (int i = 0; i < 2; i++) {
+        free(c->lists[i].cmds);
+        free(c->lists[i].data);
+    }
+    free(c->scratch);
+    free(c->tiles);
+    memset(c, 0, sizeof(RRCompositor));
+}
+
+void rrCompositorInvalidate(RRCompositor* c) {
+    c->fullRepaint = 1;
+}
+
+void rrCompositorSetTarget(RRCompositor* c, RRRenderer* target) {
+    c->target = target;
+}
@@ -0,0 +1,82 @@
+/*
+ * 文件名: rr_compose.h
+ * 描述: 脏矩形合成器: 本身是一个绘制后端，画面代码照常每帧画完整画面，它只把图元记成绘制列表
+ *       present 时与上一帧的列表比较，没变的图元 (类型、坐标、颜色、文字都相同) 不产生损坏，
+ *       新出现 / 消失 / 改变 / 换了前后顺序的图元，外接框标进损坏方块，方块连成脏矩形
+ *       然后对每个脏矩形设置裁剪，把本帧与它相交的图元按原顺序重放到真正的后端，
+ *       脏矩形以外的像素就是上一帧留在缓冲里的内容 (静止的部分不重画)
+ *       依赖后端在裁剪框内画出的像素与不裁剪时相同 (rr_render_soft 和 EasyX 都满足)
+ *       画进图层的图元不进本帧列表，图层画完时整段直接重放到后端的图层里；
+ *       贴图层是一条普通图元，带着图层的版本，图层重建过就算改变
+ */
+#ifndef RR_COMPOSE_H
+#define RR_COMPOSE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rr_render.h"
+
+#define RR_DAMAGE_TILE 16           // 损坏按这么大的方块记，方块再按行连成脏矩形
+#define RR_DAMAGE_MAX_RECTS 256     // 脏矩形超过这么多个时整屏重画
+#define RR_DAMAGE_RECT_COST 1024    // 估算代价时每个脏矩形的固定开销 (折合像素数: 设裁剪、扫一遍绘制列表)
+#define RR_DAMAGE_FULL_PERCENT 60   // 估算代价 (脏像素 + 每个矩形的开销) 超过整屏这么多时直接整屏重画
+#define RR_COMPOSE_LAYERS 32        // 记版本的图层数 (背景图层 + HUD 文字)，超过时轮流挤掉旧的
+
+// --- 一条记录下来的图元 ---
+typedef struct {
+    int op;                 // 对应 RRRenderOps 的哪个函数
+    int a, b, c, d;         // 坐标参数 (含义同 RRRenderOps)
+    RRColor color;
+    int textHeight;
+    int data;               // 文字 / 顶点在列表附带数据里的偏移
+    int count;              // 顶点数 (贴图层: 图层内容的版本)
+    void* layer;            // 贴的图层
+    RRRect bounds;          // 外接框 (已裁到屏幕)
+    uint32_t hash;          // 以上全部内容的哈希
+} RRDrawCmd;
+
+typedef struct {
+    RRDrawCmd* cmds;
+    int count, capacity;
+    char* data;             // 文字和多边形顶点
+    int dataSize, dataCapacity;
+} RRDrawList;
+
+typedef struct {
+    RRRenderer* target;     // 真正画图的后端
+    RRDrawList lists[2];    // 本帧 / 上一帧
+    int current;
+    int fullRepaint;        // 下一帧整屏重画 (第一帧、目标被别人画过时)
+    RRRect recordClip;      // 画面代码当前设置的裁剪框
+    void* building;         // 正在画的图层，NULL = 在画屏幕
+    int layerStart;         // 图层的图元从本帧列表的哪里开始 (画完后截掉)
+    int layerDataStart;
+    int layerVersion;       // 每画完一次图层加一
+    void* layers[RR_COMPOSE_LAYERS];    // 每个图层最近一次画完时的版本，只有重画过的那个图层算改变
+    int versions[RR_COMPOSE_LAYERS];
+    int layerCount;
+    int layerEvict;
+    void* scratch;          // 比较两帧用的临时数组
+    size_t scratchSize;
+
+    unsigned char* tiles;   // 每个方块是否损坏 (第一次比较时按目标大小分配，分配不了就整屏重画)
+    int tileCols, tileRows;
+    RRRect damage[RR_DAMAGE_MAX_RECTS];
+    int damageCount;
+
+    // 统计 (上一帧)
+    int lastCmds;
+    int lastDamageRects;
+    long long lastDamagePixels;
+} RRCompositor;
+
+// r 接到合成器上，合成器画到 target
+void rrCompositorInit(RRRenderer* r, RRCompositor* c, RRRenderer* target);
+void rrCompositorFree(RRCompositor* c);
+// 目标缓冲的内容失效 (窗口被覆盖、改了大小等)，下一帧整屏重画
+void rrCompositorInvalidate(RRCompositor* c);
+// 换一个目标，须和原来的目标画到同一块缓冲、共用图层 (比如临时在前面接一层命令缓冲)
+void rrCompositorSetTarget(RRCompositor* c, RRRenderer* target);
+
+#endif
@@ -0,0 +1,667 @@
+/*
+ * 文件名: rr_core.cpp
+ * 描述: 游戏核心模拟，逻辑来自 new.cpp 的 initGame / updateDino / updateObstacles /
+ *       generateObstacle / updateClouds / checkCollision，去掉了全局变量和图形调用
+ */
+#include <limits.h>
+
+#include "rr_core.h"
+#include "rr_collide.h"
+#include "rr_jump.h"
+#include "rr_cpu.h"
+
+// --- 配置数据 ---
+GameConfig levelConfigs[LEVEL_COUNT] = {
+    // 简单模式
+    {0, "简单模式", 800, 2, 0, 30, 100, 0},
+    // 普通模式
+    {1, "普通模式", 1000, 3, 1, 45, 80, 0},
+    // 困难模式
+    {2, "困难模式", 1200, 5, 2, 60, 60, 0}
+};
+
+CharacterConfig charConfigs[CHAR_COUNT] = {
+    // 默认恐龙
+    {CHAR_DEFAULT, "普通龙", 80, 180, 80, 1.0, rrJumpMultipliers[0] / (float)RR_FIX_ONE, rrGravityMultipliers[0] / (float)RR_FIX_ONE, 0},
+    // 速度型
+    {CHAR_SPEEDY, "速度龙", 255, 100, 100, 1.3, rrJumpMultipliers[1] / (float)RR_FIX_ONE, rrGravityMultipliers[1] / (float)RR_FIX_ONE, 0},
+    // 坦克型
+    {CHAR_TANK, "坦克龙", 100, 100, 255, 0.8, rrJumpMultipliers[2] / (float)RR_FIX_ONE, rrGravityMultipliers[2] / (float)RR_FIX_ONE, 1}
+};
+
+// --- 起跳轨迹表 (编译期生成) ---
+static constexpr RRJumpTrack jumpTracks[CHAR_COUNT][RR_GRAVITY_LEVELS] = {
+    RR_JUMP_TRACKS(CHAR_DEFAULT),
+    RR_JUMP_TRACKS(CHAR_SPEEDY),
+    RR_JUMP_TRACKS(CHAR_TANK)
+};
+
+// 正常重力下: 普通龙第 8 步最高 72、第 21 步落地；坦克龙最高 56；
+// 速度龙的重力不到 1，速度截断到 0 后就不再变化，停在 210 的高度上 (只能靠下蹲落地)
+static_assert(jumpTracks[CHAR_DEFAULT][RR_GRAVITY_NORMAL - 1].rise[8] == 72, "jump apex");
+static_assert(jumpTracks[CHAR_DEFAULT][RR_GRAVITY_NORMAL - 1].landing == 21, "jump landing");
+static_assert(jumpTracks[CHAR_TANK][RR_GRAVITY_NORMAL - 1].rise[7] == 56, "jump apex");
+static_assert(jumpTracks[CHAR_SPEEDY][RR_GRAVITY_NORMAL - 1].landing == RR_JUMP_HOVER, "hover");
+
+// --- 内部函数声明 ---
+static void updateDino(RRWorld* w);
+static void generateObstacle(RRWorld* w);
+static int placeObstacle(RRWorld* w);
+static void spawnOnBeats(RRWorld* w);
+static void moveObstacles(RRWorld* w);
+static void updateObstacles(RRWorld* w);
+static void updateClouds(RRWorld* w);
+static void checkCollision(RRWorld* w, const RRStepSweep* sweep);
+
+// --- 初始化函数 ---
+void rrInitWorld(RRWorld* w, CharacterType charType, DifficultyLevel level, unsigned long long seed) {
+    GameConfig* levelConfig = &levelConfigs[level];
+
+    w->charType = charType;
+    w->level = level;
+    w->gameOver = 0;
+    w->deathCause = -1;
+    w->seed = seed;
+    rrRngSeed(&w->spawnRng, seed, RR_STREAM_SPAWN);
+    rrRngSeed(&w->cloudRng, seed, RR_STREAM_CLOUDS);
+    w->beats.ticks = NULL;
+    w->beats.count = 0;
+    w->beats.loopTicks = 0;
+    w->nextBeat = 0;
+    w->lastBeatTick = INT_MIN / 2;
+    // GameConfig.gravity 目前只在界面上显示，各难度都按正常重力
+    w->gravityLevel = RR_GRAVITY_NORMAL;
+
+    // 初始化恐龙
+    w->dino.x = 100;
+    w->dino.y = GROUND_Y - DINO_HEIGHT;
+    w->dino.width = DINO_WIDTH;
+    w->dino.height = DINO_HEIGHT;
+    w->dino.velocityY = 0;
+    w->dino.isJumping = 0;
+    w->dino.isDucking = 0;
+    w->dino.frame = 0;
+    w->dino.lives = (charType == CHAR_TANK) ? 3 : 1;  // 坦克型有3条命
+    w->dino.type = charType;
+    w->dino.jumpTick = -1;
+
+    // 初始化障碍物
+    w->obstacles.count = 0;
+    w->obstacles.nextId = 0;
+    w->lastObstacleRight = -WIN_WIDTH;
+    w->lastObstacleNeed = RR_NEED_PASS;
+    w->fairMode = RR_FAIR_REPAIR;
+    w->ghost = 0;
+    w->repairedSpawns = 0;
+    w->deferredSpawns = 0;
+    w->unfairSpawns = 0;
+    w->firstUnfairTick = -1;
+
+    // 初始化云朵
+    w->cloudCount = RR_CLOUD_COUNT;
+    for (int i = 0; i < w->cloudCount; i++) {
+        w->clouds[i].x = rrRngRange(&w->cloudRng, WIN_WIDTH);
+        w->clouds[i].y = 50 + rrRngRange(&w->cloudRng, 200);
+        w->clouds[i].speed = 1 + rrRngRange(&w->cloudRng, 3);
+    }
+
+    // 重置游戏参数
+    w->score = 0;
+    w->gameSpeed = GAME_SPEED * levelConfig->speed / 1000;
+    w->frameCount = 0;
+    w->framesSinceLastObstacle = 0;
+
+    // 根据难度设置生成参数
+    w->nextSpawnInterval = MIN_SPAWN_INTERVAL + (MAX_SPAWN_INTERVAL - MIN_SPAWN_INTERVAL) * (100 - levelConfig->obstacleDensity) / 100;
+    w->nextMinDistance = MIN_OBSTACLE_DISTANCE + rrRngRange(&w->spawnRng, MAX_OBSTACLE_DISTANCE - MIN_OBSTACLE_DISTANCE);
+
+    // 游戏开始时立即尝试生成第一个障碍物
+    w->framesSinceLastObstacle = w->nextSpawnInterval;
+}
+
+void rrSetBeatTrack(RRWorld* w, const int* ticks, int count, int loopTicks) {
+    w->beats.ticks = (count > 0) ? ticks : NULL;
+    w->beats.count = count;
+    w->beats.loopTicks = loopTicks;
+    w->nextBeat = 0;
+}
+
+// --- 推进一步 ---
+void rrStep(RRWorld* w, const RRInput* in) {
+    RRStepSweep sweep;
+    if (!rrStepMove(w, in, &sweep)) return;
+    rrStepFinish(w, &sweep, 1);
+}
+
+int rrStepMove(RRWorld* w, const RRInput* in, RRStepSweep* sweep) {
+    if (w->gameOver) return 0;
+
+    // 输入 (对应 handleInput 中 STATE_GAME 的处理)
+    if (in->jump && !w->dino.isJumping) {
+        // 起跳速度按角色配置，已在轨迹表里
+        w->dino.velocityY = rrJumpTrack(w->charType, w->gravityLevel)->takeoff;
+        w->dino.isJumping = 1;
+        // 从站立位置起跳才能按表走 (上一步还蹲着时起点低 20)
+        w->dino.jumpTick = (w->dino.y == GROUND_Y - DINO_HEIGHT) ? 0 : -1;
+    }
+    w->dino.isDucking = in->duck ? 1 : 0;
+
+    // 记下步开始时的位置，碰撞按整步的连续运动检测
+    int prevY = w->dino.y;
+    int prevHeight = w->dino.height;
+    sweep->speed = w->gameSpeed;
+
+    updateDino(w);
+    moveObstacles(w);
+
+    // 下蹲/起身是瞬间变化的，这一步按结束时的姿态静止处理
+    sweep->prevY = (w->dino.height != prevHeight) ? w->dino.y : prevY;
+    return 1;
+}
+
+void rrStepFinish(RRWorld* w, const RRStepSweep* sweep, int collide) {
+    // 先检测再回收: 这一步刚越过恐龙的障碍物也要扫掠到
+    if (collide && !w->ghost) checkCollision(w, sweep);
+    updateObstacles(w);
+    updateClouds(w);
+    w->frameCount++;
+    w->framesSinceLastObstacle++;
+}
+
+static void updateDino(RRWorld* w) {
+    Dino* dino = &w->dino;
+    const RRJumpTrack* track = rrJumpTrack(dino->type, w->gravityLevel);
+
+    if (dino->jumpTick >= 0) {
+        // 标准起跳: 直接查表 (悬停的轨迹停在最后一格)
+        if (dino->jumpTick < RR_JUMP_MAX_TICKS) dino->jumpTick++;
+        dino->y = GROUND_Y - DINO_HEIGHT - track->rise[dino->jumpTick];
+        dino->velocityY = track->velocity[dino->jumpTick];
+        if (dino->jumpTick == track->landing) {
+            dino->isJumping = 0;
+            dino->jumpTick = -1;
+        }
+    } else {
+        // 其他情况照常积分 (重力按角色配置，定点数)
+        dino->velocityY = rrJumpStep(track->gravity, dino->velocityY);
+        dino->y += dino->velocityY;
+
+        if (dino->y >= GROUND_Y - dino->height) {
+            dino->y = GROUND_Y - dino->height;
+            dino->velocityY = 0;
+            dino->isJumping = 0;
+        }
+    }
+
+    if (dino->isDucking) {
+        dino->jumpTick = -1;        // 下蹲直接落地，离开轨迹表
+        dino->height = DINO_HEIGHT - 20;
+        dino->y = GROUND_Y - dino->height;
+    } else {
+        dino->height = DINO_HEIGHT;
+    }
+}
+
+static void generateObstacle(RRWorld* w) {
+    RRObstaclePool* obs = &w->obstacles;
+
+    if (obs->count >= MAX_OBSTACLES_ON_SCREEN) return;
+    if (w->framesSinceLastObstacle < w->nextSpawnInterval) return;
+
+    int minDistance = WIN_WIDTH;
+    for (int i = 0; i < obs->count; i++) {
+        int distance = WIN_WIDTH - obs->x[i];
+        if (distance < minDistance) minDistance = distance;
+    }
+
+    if (obs->count > 0 && minDistance < w->nextMinDistance) {
+        if (w->framesSinceLastObstacle > MAX_SPAWN_INTERVAL * 2) {
+            // 强制生成
+        } else {
+            return;
+        }
+    }
+
+    placeObstacle(w);
+}
+
+// 在右边缘放一个障碍物 (类型、高度随机)，并更新随机模式的生成参数
+// 无法通过的组合先修复 (鸟挪到能蹲过的高度、大仙人掌换成小的)，修不了就这次不生成，返回 0
+static int placeObstacle(RRWorld* w) {
+    RRObstaclePool* obs = &w->obstacles;
+
+    // 根据难度调整障碍物类型概率
+    GameConfig* config = &levelConfigs[w->level];
+    int type;
+    int typeRand = rrRngRange(&w->spawnRng, 100);
+
+    if (typeRand < 40) type = 0;
+    else if (typeRand * 100 < 4000 + config->obstacleDensity * 35) type = 1;   // 40 + 密度 * 0.35，整数比较
+    else type = 2;
+
+    for (int i = 0; i < obs->count; i++) {
+        if (obs->type[i] == type) {
+            if (rrRngRange(&w->spawnRng, 2) == 0) type = (type + 1) % 3;
+            break;
+        }
+    }
+
+    int width, height, y;
+    if (type == 0) {
+        width = CACTUS_WIDTH;
+        height = CACTUS_HEIGHT;
+        y = GROUND_Y - CACTUS_HEIGHT;
+    } else if (type == 1) {
+        width = CACTUS_WIDTH + 10;
+        height = CACTUS_HEIGHT + 20;
+        y = GROUND_Y - (CACTUS_HEIGHT + 20);
+    } else {
+        width = BIRD_WIDTH;
+        height = BIRD_HEIGHT;
+        y = GROUND_Y - config->birdHeight - rrRngRange(&w->spawnRng, 30);
+    }
+
+    // 公平性: 和上一个障碍物连起来也要过得去
+    // 间距是上一个离开恐龙到这一个碰到恐龙之间走过的距离
+    int gap = WIN_WIDTH - w->lastObstacleRight - DINO_WIDTH;
+    int need = rrObstacleNeed(w->charType, w->gravityLevel, w->gameSpeed, y, width, height);
+    int fair = rrSequenceFair(w->charType, w->gravityLevel, w->gameSpeed, w->lastObstacleNeed, gap, need, GROUND_Y - y);
+    if (!fair && w->fairMode == RR_FAIR_REPAIR) {
+        if (type == 2) {
+            y = GROUND_Y - (DINO_HEIGHT - 20) - BIRD_HEIGHT;   // 底边贴着下蹲的头顶
+        } else if (type == 1) {
+            type = 0;
+            width = CACTUS_WIDTH;
+            height = CACTUS_HEIGHT;
+            y = GROUND_Y - CACTUS_HEIGHT;
+        }
+        need = rrObstacleNeed(w->charType, w->gravityLevel, w->gameSpeed, y, width, height);
+        fair = rrSequenceFair(w->charType, w->gravityLevel, w->gameSpeed, w->lastObstacleNeed, gap, need, GROUND_Y - y);
+        if (!fair) {
+            w->deferredSpawns++;
+            return 0;
+        }
+        w->repairedSpawns++;
+    } else if (!fair) {
+        if (w->unfairSpawns++ == 0) w->firstUnfairTick = w->frameCount;
+    }
+
+    int i = rrObstacleSpawn(obs);
+    obs->type[i] = type;
+    obs->x[i] = WIN_WIDTH;
+    obs->width[i] = width;
+    obs->height[i] = height;
+    obs->y[i] = y;
+    w->lastObstacleRight = WIN_WIDTH + width;
+    w->lastObstacleNeed = need;
+
+    w->framesSinceLastObstacle = 0;
+
+    // 更新生成参数
+    int baseSpawnInterval = 35 - (w->gameSpeed - GAME_SPEED) * 2;
+    if (baseSpawnInterval < MIN_SPAWN_INTERVAL) baseSpawnInterval = MIN_SPAWN_INTERVAL;
+    w->nextSpawnInterval = baseSpawnInterval + rrRngRange(&w->spawnRng, 20);
+    if (w->nextSpawnInterval < MIN_SPAWN_INTERVAL) w->nextSpawnInterval = MIN_SPAWN_INTERVAL;
+    if (w->nextSpawnInterval > MAX_SPAWN_INTERVAL) w->nextSpawnInterval = MAX_SPAWN_INTERVAL;
+    return 1;
+}
+
+// 第 i 拍的步数，没有了返回 INT_MAX
+static int beatTick(const RRWorld* w, int i) {
+    const RRBeatTrack* b = &w->beats;
+    if (b->loopTicks <= 0) return (i < b->count) ? b->ticks[i] : INT_MAX;
+    return b->ticks[i % b->count] + (i / b->count) * b->loopTicks;
+}
+
+// 节拍模式: 提前 "飞行时间" 生成，让障碍物正好在拍子上到达恐龙身前
+// 拍子比难度允许的间隔还密时跳过 (间隔与随机模式开局的生成间隔相同)
+static void spawnOnBeats(RRWorld* w) {
+    GameConfig* config = &levelConfigs[w->level];
+    int minGap = MIN_SPAWN_INTERVAL + (MAX_SPAWN_INTERVAL - MIN_SPAWN_INTERVAL) * (100 - config->obstacleDensity) / 100;
+    int travel = (WIN_WIDTH - w->dino.x - w->dino.width) / w->gameSpeed;
+
+    for (;;) {
+        int beat = beatTick(w, w->nextBeat);
+        if (beat == INT_MAX || beat - travel > w->frameCount) return;
+        w->nextBeat++;
+
+        if (beat - travel < w->frameCount) continue;        // 开头赶不上的拍
+        if (beat - w->lastBeatTick < minGap) continue;
+        if (w->obstacles.count >= MAX_OBSTACLES_ON_SCREEN) continue;
+
+        if (placeObstacle(w)) w->lastBeatTick = beat;
+    }
+}
+
+static void moveObstacles(RRWorld* w) {
+    RRObstaclePool* obs = &w->obstacles;
+    int* x = obs->x;
+    int speed = w->gameSpeed;
+
+    // 连续数组上的纯算术，可向量化
+    for (int i = 0; i < obs->count; i++) {
+        x[i] -= speed;
+    }
+    if (w->lastObstacleRight > -WIN_WIDTH) w->lastObstacleRight -= speed;
+}
+
+static void updateObstacles(RRWorld* w) {
+    RRObstaclePool* obs = &w->obstacles;
+    int* x = obs->x;
+
+    // 回收: 倒序遍历，补位过来的元素已经检查过
+    for (int i = obs->count - 1; i >= 0; i--) {
+        int right = x[i] + obs->width[i];
+
+        if (right < 0) {
+            rrObstacleRetire(obs, i);
+            w->framesSinceLastObstacle = w->nextSpawnInterval;
+        } else if (right < w->dino.x) {
+            rrObstacleRetire(obs, i);
+            w->score += 10;
+
+            if (w->score % 500 == 0 && w->gameSpeed < 25) {
+                w->gameSpeed += 1;
+            }
+        }
+    }
+
+    w->framesSinceLastObstacle++;
+
+    if (w->beats.ticks != NULL) {
+        spawnOnBeats(w);
+        return;
+    }
+
+    if (w->framesSinceLastObstacle > MAX_SPAWN_INTERVAL) {
+        generateObstacle(w);
+        return;
+    }
+
+    if (obs->count < MAX_OBSTACLES_ON_SCREEN && w->framesSinceLastObstacle > w->nextSpawnInterval) {
+        int baseChance = 10 + (w->gameSpeed - GAME_SPEED) * 3;
+        int randomChance = baseChance - 5 + rrRngRange(&w->spawnRng, 11);
+        if (randomChance < 5) randomChance = 5;
+
+        if (rrRngRange(&w->spawnRng, 100) < randomChance) {
+            generateObstacle(w);
+            return;
+        }
+    }
+
+    if (obs->count == 0 && w->framesSinceLastObstacle > 20) {
+        generateObstacle(w);
+        return;
+    }
+}
+
+static void updateClouds(RRWorld* w) {
+    for (int i = 0; i < w->cloudCount; i++) {
+        Cloud* c = &w->clouds[i];
+        c->x -= c->speed;
+
+        if (c->x + 70 < 0) {
+            c->x = WIN_WIDTH;
+            c->y = 50 + rrRngRange(&w->cloudRng, 200);
+            c->speed = 1 + rrRngRange(&w->cloudRng, 3);
+        }
+    }
+}
+
+// --- 起跳轨迹查询 ---
+const RRJumpTrack* rrJumpTrack(CharacterType c, int gravityLevel) {
+    return &jumpTracks[c][gravityLevel - 1];
+}
+
+int rrLandingTicks(const RRWorld* w) {
+    const Dino* dino = &w->dino;
+    if (!dino->isJumping) return 0;
+
+    const RRJumpTrack* track = rrJumpTrack(dino->type, w->gravityLevel);
+    if (dino->jumpTick >= 0) {
+        return (track->landing == RR_JUMP_HOVER) ? -1 : track->landing - dino->jumpTick;
+    }
+    // 不在表上 (蹲着起跳等): 按 updateDino 的积分往前推
+    int y = dino->y, v = dino->velocityY;
+    for (int t = 1; t <= RR_JUMP_MAX_TICKS; t++) {
+        v = rrJumpStep(track->gravity, v);
+        y += v;
+        if (y >= GROUND_Y - dino->height) return t;
+    }
+    return -1;
+}
+
+// --- 状态哈希 ---
+// 逐个字段按值混合 (不哈希内存，结构体里的填充字节和 beats 指针不算)
+static void hashMix(uint64_t* h, int64_t v) {
+    *h = (*h ^ (uint64_t)v) * 0x100000001B3ull;
+    *h ^= *h >> 29;
+}
+
+uint64_t rrWorldHash(const RRWorld* w) {
+    uint64_t h = 0x243F6A8885A308D3ull;
+    const Dino* d = &w->dino;
+    const RRObstaclePool* obs = &w->obstacles;
+
+    hashMix(&h, w->frameCount);
+    hashMix(&h, w->score);
+    hashMix(&h, w->gameSpeed);
+    hashMix(&h, w->gameOver);
+    hashMix(&h, w->deathCause);
+    hashMix(&h, w->charType);
+    hashMix(&h, w->level);
+    hashMix(&h, w->gravityLevel);
+    hashMix(&h, w->fairMode);
+    hashMix(&h, w->ghost);
+    hashMix(&h, (int64_t)w->seed);
+
+    hashMix(&h, d->x);
+    hashMix(&h, d->y);
+    hashMix(&h, d->width);
+    hashMix(&h, d->height);
+    hashMix(&h, d->velocityY);
+    hashMix(&h, d->isJumping);
+    hashMix(&h, d->isDucking);
+    hashMix(&h, d->frame);
+    hashMix(&h, d->lives);
+    hashMix(&h, d->jumpTick);
+
+    hashMix(&h, obs->count);
+    hashMix(&h, obs->nextId);
+    for (int i = 0; i < obs->count; i++) {
+        hashMix(&h, obs->id[i]);
+        hashMix(&h, obs->type[i]);
+        hashMix(&h, obs->x[i]);
+        hashMix(&h, obs->y[i]);
+        hashMix(&h, obs->width[i]);
+        hashMix(&h, obs->height[i]);
+    }
+
+    hashMix(&h, w->cloudCount);
+    for (int i = 0; i < w->cloudCount; i++) {
+        hashMix(&h, w->clouds[i].x);
+        hashMix(&h, w->clouds[i].y);
+        hashMix(&h, w->clouds[i].speed);
+    }
+
+    hashMix(&h, w->framesSinceLastObstacle);
+    hashMix(&h, w->nextSpawnInterval);
+    hashMix(&h, w->nextMinDistance);
+    hashMix(&h, w->nextBeat);
+    hashMix(&h, w->lastBeatTick);
+    hashMix(&h, w->lastObstacleRight);
+    hashMix(&h, w->lastObstacleNeed);
+    hashMix(&h, w->repairedSpawns);
+    hashMix(&h, w->deferredSpawns);
+    hashMix(&h, w->unfairSpawns);
+    hashMix(&h, w->firstUnfairTick);
+    for (int i = 0; i < 4; i++) {
+        hashMix(&h, w->spawnRng.s[i]);
+        hashMix(&h, w->cloudRng.s[i]);
+    }
+
+    // splitmix64 的收尾
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+    return h ^ (h >> 31);
+}
+
+// --- 公平性检查 ---
+// 碰撞是按步内线性插值扫掠的，所以对每条起跳轨迹和每个高度 h 记下
+// (插值后的) 离地高度 >= h 的连续时间区间 [enter, enter + span]，单位是 RR_FAIR_ONE 分之一步
+// 生成时只查表，O(1)
+typedef struct {
+    int enter[CHAR_COUNT][RR_GRAVITY_LEVELS][RR_FAIR_MAX_RISE + 1];
+    int span[CHAR_COUNT][RR_GRAVITY_LEVELS][RR_FAIR_MAX_RISE + 1];  // 跳不到这个高度为 -1
+} FairTables;
+
+static void buildFairTable(const RRJumpTrack* track, int* enterOut, int* spanOut) {
+    int rise[RR_JUMP_MAX_TICKS + 2];
+    int air = (track->landing == RR_JUMP_HOVER) ? RR_JUMP_MAX_TICKS : track->landing;
+    for (int k = 0; k <= air; k++) rise[k] = track->rise[k];
+    rise[air + 1] = (track->landing == RR_JUMP_HOVER) ? rise[air] : 0;   // 悬停不会掉下来
+
+    for (int h = 0; h <= RR_FAIR_MAX_RISE; h++) {
+        // 轨迹是单峰的: 找第一个和最后一个够高的步，再在相邻两步之间插值
+        int first = -1, last = -1;
+        for (int k = 1; k <= air; k++) {
+            if (rise[k] < h || h == 0) continue;
+            if (first < 0) first = k;
+            last = k;
+        }
+        if (first < 0) {
+            enterOut[h] = 0;
+            spanOut[h] = (h == 0) ? RR_JUMP_MAX_TICKS * RR_FAIR_ONE : -1;
+            continue;
+        }
+        int enter = (first - 1) * RR_FAIR_ONE +
+                    (h - rise[first - 1]) * RR_FAIR_ONE / (rise[first] - rise[first - 1]);
+        int leave = last * RR_FAIR_ONE;
+        if (rise[last + 1] < rise[last]) {
+            leave += (rise[last] - h) * RR_FAIR_ONE / (rise[last] - rise[last + 1]);
+        }
+        enterOut[h] = enter;
+        spanOut[h] = leave - enter;
+    }
+}
+
+static void buildFairTables(FairTables* t) {
+    for (int c = 0; c < CHAR_COUNT; c++) {
+        for (int g = 0; g < RR_GRAVITY_LEVELS; g++) {
+            buildFairTable(&jumpTracks[c][g], t->enter[c][g], t->span[c][g]);
+        }
+    }
+}
+
+static const FairTables* fairTables() {
+    static FairTables tables;
+    static int built = (buildFairTables(&tables), 1);   // 局部静态初始化是线程安全的
+    (void)built;
+    return &tables;
+}
+
+int rrObstacleNeed(CharacterType c, int gravityLevel, int speed, int y, int width, int height) {
+    int bottom = y + height;
+    if (bottom <= GROUND_Y - DINO_HEIGHT) return RR_NEED_PASS;
+    if (bottom <= GROUND_Y - (DINO_HEIGHT - 20)) return RR_NEED_DUCK;
+
+    int top = GROUND_Y - y;
+    if (top > RR_FAIR_MAX_RISE) return RR_NEED_NONE;
+    // 障碍物和恐龙横向重叠 (DINO_WIDTH + width) / speed 步，这段时间必须整个落在够高的区间里；
+    // 起跳只能在整步上，所以区间还要再长出 1 步 (任何对齐都有一个可用的起跳步) 和 RR_FAIR_SLACK 步余量
+    long long span = fairTables()->span[c][gravityLevel - 1][top];
+    long long need = (long long)(DINO_WIDTH + width) * RR_FAIR_ONE + (1 + RR_FAIR_SLACK) * speed * RR_FAIR_ONE;
+    return (span >= 0 && span * speed >= need) ? RR_NEED_JUMP : RR_NEED_NONE;
+}
+
+// 下蹲会让空中的恐龙立刻落地，按住下蹲的那一步先取整到步边界 (最多 1 步)，
+// 落地后再过 2 步才能重新起跳 (isJumping 晚一步清除)；站着的恐龙下一步就能起跳
+int rrSequenceFair(CharacterType c, int gravityLevel, int speed, int prevNeed, int gapPixels, int need, int top) {
+    if (need == RR_NEED_NONE) return 0;
+    if (need == RR_NEED_PASS && prevNeed == RR_NEED_PASS) return 1;
+
+    long long gap = (long long)gapPixels * RR_FAIR_ONE;
+    long long tick = (long long)speed * RR_FAIR_ONE;    // 一步走过的距离
+    if (need != RR_NEED_JUMP) {
+        // 高飞的鸟对空中的恐龙也是障碍，和要蹲的鸟一样先落地
+        return gap >= (prevNeed == RR_NEED_JUMP ? 1 + RR_FAIR_SLACK : 0) * tick;
+    }
+
+    // 起跳在整步上，再取整 1 步
+    int wait = (prevNeed == RR_NEED_JUMP) ? 1 + 2 + 1 : (prevNeed == RR_NEED_DUCK) ? 1 + 1 : 1;
+    long long enter = fairTables()->enter[c][gravityLevel - 1][top];
+    return gap >= enter * speed + (wait + RR_FAIR_SLACK) * tick;
+}
+
+// --- 扫掠碰撞 ---
+// 约束 a + b*t > 0 收紧区间 [lo, hi]，b == 0 时约束与 t 无关
+static int clipOpen(int a, int b, RRTime* lo, RRTime* hi) {
+    if (b == 0) return a > 0;
+    if (b > 0) {
+        RRTime t = {-a, b};             // t > -a/b
+        if (rrTimeLess(*lo, t)) *lo = t;
+    } else {
+        RRTime t = {a, -b};             // t < a/(-b)
+        if (rrTimeLess(t, *hi)) *hi = t;
+    }
+    return 1;
+}
+
+int rrSweepAABB(int ax, int ay, int aw, int ah,
+                int bx, int by, int bw, int bh,
+                int dx, int dy, RRTime* toi) {
+    RRTime lo = {0, 1};
+    RRTime hi = {1, 1};
+
+    // ax < bx + dx*t + bw,  ax + aw > bx + dx*t  (y 方向同理)
+    if (!clipOpen(bx + bw - ax, dx, &lo, &hi)) return 0;
+    if (!clipOpen(ax + aw - bx, -dx, &lo, &hi)) return 0;
+    if (!clipOpen(by + bh - ay, dy, &lo, &hi)) return 0;
+    if (!clipOpen(ay + ah - by, -dy, &lo, &hi)) return 0;
+    if (!rrTimeLess(lo, hi)) return 0;
+
+    *toi = lo;
+    return 1;
+}
+
+// 恐龙在步内从 sweep->prevY 匀速移到当前 y，障碍物向左移动 speed；按首次接触的先后处理
+static void checkCollision(RRWorld* w, const RRStepSweep* sweep) {
+    Dino* dino = &w->dino;
+    RRObstaclePool* obs = &w->obstacles;
+    int prevY = sweep->prevY;
+    int speed = sweep->speed;
+    int dinoDy = dino->y - prevY;
+    RRSweepBox box = rrStepSweepBox(w, sweep);
+    RRBoxColumns boxes = rrPoolColumns(obs);
+    uint32_t mask[RR_MASK_WORDS(MAX_OBSTACLES_ON_SCREEN)];
+
+    for (;;) {
+        int first = -1;
+        RRTime firstToi = {1, 1};
+
+        rrCollideQuery(box.x0, box.y0, box.x1, box.y1, &boxes, obs->count, mask);
+        for (int word = 0; word < RR_MASK_WORDS(obs->count); word++) {
+            for (uint32_t bits = mask[word]; bits != 0; bits &= bits - 1) {
+                int i = word * 32 + rrLowestBit(bits);
+                RRTime toi;
+                if (rrSweepAABB(dino->x, prevY, dino->width, dino->height,
+                                obs->x[i] + speed, obs->y[i], obs->width[i], obs->height[i],
+                                -speed, -dinoDy, &toi) &&
+                    (first < 0 || rrTimeLess(toi, firstToi))) {
+                    first = i;
+                    firstToi = toi;
+                }
+            }
+        }
+        if (first < 0) return;
+
+        if (dino->lives > 1) {
+            dino->lives--;
+            rrObstacleRetire(obs, first);
+        } else {
+            w->gameOver = 1;
+            w->deathCause = obs->type[first];
+            return;
+        }
+    }
+}
@@ -0,0 +1,272 @@
+/*
+ * 文件名: rr_core.h
+ * 描述: 游戏核心模拟 (rr_core)，不依赖 graphics.h / windows.h
+ *       世界状态 + rrStep(world, input)，Windows 客户端与 Linux 工具共用
+ */
+#ifndef RR_CORE_H
+#define RR_CORE_H
+
+#include "rr_random.h"
+
+// --- 全局常量 ---
+#define WIN_WIDTH 800
+#define WIN_HEIGHT 600
+#define GROUND_Y 500
+#define DINO_WIDTH 40
+#define DINO_HEIGHT 110
+#define CACTUS_WIDTH 20
+#define CACTUS_HEIGHT 40
+#define BIRD_WIDTH 30
+#define BIRD_HEIGHT 20
+#define GRAVITY_FIX 65733      // 重力 1.003 (Q16.16)
+#define JUMP_STRENGTH 18
+#define GAME_SPEED 10
+#define MIN_OBSTACLE_DISTANCE 300
+#define MAX_OBSTACLE_DISTANCE 600
+#define MIN_SPAWN_INTERVAL 25
+#define MAX_SPAWN_INTERVAL 60
+#define MAX_OBSTACLES_ON_SCREEN 500
+
+#define RR_CLOUD_COUNT 5        // 云朵数量
+#define RR_FIX_SHIFT 16         // 模拟里的小数用 Q16.16 定点整数，不用 float
+#define RR_FIX_ONE (1 << RR_FIX_SHIFT)
+#define RR_JUMP_MAX_TICKS 64    // 起跳轨迹表的长度 (步)
+#define RR_JUMP_HOVER 0         // 轨迹表 landing: 速度减到 0 后悬停，不会自己落地
+#define RR_GRAVITY_LEVELS 5     // 重力等级 1..5 (GameConfig.gravity: 1=飘, 3=正常, 5=重)
+#define RR_GRAVITY_NORMAL 3
+#define RR_FAIR_MAX_RISE 255    // 公平性表: 最高起跳高度
+#define RR_FAIR_ONE 256         // 公平性表的时间精度 (一步的几分之一)
+#define RR_FAIR_SLACK 1         // 按键时机至少要有这么多步的余量，不要求逐帧精确
+
+// --- 角色类型 ---
+typedef enum {
+    CHAR_DEFAULT,    // 默认恐龙
+    CHAR_SPEEDY,     // 速度快，跳跃高
+    CHAR_TANK,       // 生命值高，速度慢
+    CHAR_COUNT       // 角色总数
+} CharacterType;
+
+// --- 难度级别 ---
+typedef enum {
+    LEVEL_EASY,      // 简单
+    LEVEL_NORMAL,    // 普通
+    LEVEL_HARD,      // 困难
+    LEVEL_COUNT      // 难度总数
+} DifficultyLevel;
+
+// --- 关卡配置 ---
+typedef struct {
+    int id;
+    char name[50];
+    int speed;              // 游戏速度 (1000为基准)
+    int gravity;            // 重力参数 (1=飘, 3=正常, 5=重)
+    int themeColor;         // 主题颜色 (0:绿, 1:蓝, 2:红)
+    int obstacleDensity;    // 障碍物密度
+    int birdHeight;         // 鸟的飞行高度
+    int bestScore;
+} GameConfig;
+
+// --- 角色配置 ---
+typedef struct {
+    CharacterType type;
+    char name[50];
+    int colorR, colorG, colorB;
+    float speedMultiplier;  // 速度倍率
+    float jumpMultiplier;   // 跳跃倍率 (只用于显示，模拟用 rr_jump.h 的定点数)
+    float gravityMultiplier; // 重力倍率 (同上)
+    int specialAbility;     // 特殊能力
+} CharacterConfig;
+
+// --- 游戏内部数据结构 ---
+typedef struct {
+    int x, y;
+    int width, height;
+    int velocityY;
+    int isJumping;
+    int isDucking;
+    int frame;
+    int lives;              // 生命值
+    CharacterType type;     // 角色类型
+    int jumpTick;           // 从站立位置起跳后的步数 (按轨迹表走)，-1 = 不在表上
+} Dino;
+
+// --- 起跳轨迹 (每个角色 x 重力等级一张，编译期生成，见 rr_jump.h) ---
+// 从站立位置起跳、途中不下蹲时，第 t 步结束时的状态
+typedef struct {
+    int gravity;                            // 每步加到 velocityY 上的重力 (Q16.16)
+    int takeoff;                            // 起跳时的 velocityY
+    int landing;                            // 第几步落回地面，RR_JUMP_HOVER = 不会落地
+    int rise[RR_JUMP_MAX_TICKS + 1];        // 离站立位置的高度
+    int velocity[RR_JUMP_MAX_TICKS + 1];    // velocityY
+} RRJumpTrack;
+
+// --- 步内时刻 num/den (den > 0)，0 = 步开始，1 = 步结束 ---
+typedef struct {
+    int num, den;
+} RRTime;
+
+// --- 障碍物池 (结构数组: 每个字段一列) ---
+// 在场的障碍物紧密排在 [0, count)，生成时追加到末尾，回收时用最后一个补位，
+// 都是 O(1)；逐帧移动和碰撞循环都是连续数组，编译器可以直接向量化
+typedef struct {
+    int count;                              // 在场数量，不超过 MAX_OBSTACLES_ON_SCREEN
+    int nextId;
+    int x[MAX_OBSTACLES_ON_SCREEN];
+    int y[MAX_OBSTACLES_ON_SCREEN];
+    int width[MAX_OBSTACLES_ON_SCREEN];
+    int height[MAX_OBSTACLES_ON_SCREEN];
+    int type[MAX_OBSTACLES_ON_SCREEN];      // 0:仙人掌小, 1:仙人掌大, 2:鸟
+    int id[MAX_OBSTACLES_ON_SCREEN];        // 生成序号，补位换了下标也能认出是同一个
+} RRObstaclePool;
+
+typedef struct {
+    int x, y;
+    int speed;
+} Cloud;
+
+// --- 通过一个障碍物需要的动作 ---
+typedef enum {
+    RR_NEED_PASS = 0,       // 站着就能过 (高飞的鸟)
+    RR_NEED_DUCK = 1,       // 蹲下
+    RR_NEED_JUMP = 2,       // 跳过去
+    RR_NEED_NONE = 3        // 这个角色怎么都过不去
+} RRNeed;
+
+// --- 生成时的公平性处理 ---
+typedef enum {
+    RR_FAIR_REPAIR = 0,     // 修复或推迟过不去的生成 (游戏默认)
+    RR_FAIR_REPORT = 1      // 照原样生成，只计数 (离线扫描旧规则用)
+} RRFairMode;
+
+// --- 节拍轨道 (rr_beat 的分析结果换算成步数)，数组由调用方持有 ---
+typedef struct {
+    const int* ticks;       // 每拍的步数 (升序)，NULL = 按随机间隔生成障碍物
+    int count;
+    int loopTicks;          // 曲子长度 (步)，> 0 时按循环播放往后延续
+} RRBeatTrack;
+
+// --- 一局游戏的全部状态 (可直接按值拷贝) ---
+typedef struct {
+    Dino dino;
+    RRObstaclePool obstacles;
+    Cloud clouds[RR_CLOUD_COUNT];
+    int cloudCount;
+    int score;
+    int gameSpeed;
+    int frameCount;
+    int framesSinceLastObstacle;
+    int nextSpawnInterval;
+    int nextMinDistance;
+
+    CharacterType charType;
+    DifficultyLevel level;
+    int gameOver;           // 1 = 已死亡
+    int deathCause;         // 致死的障碍物类型 (0/1/2)，存活时为 -1
+    unsigned long long seed; // 本局种子 (录像/复现用)
+    RRBeatTrack beats;      // 节拍模式: 障碍物在拍子上到达恐龙
+    int nextBeat;           // 下一个待处理的拍 (循环时继续累加)
+    int lastBeatTick;       // 上一个放了障碍物的拍
+    int gravityLevel;       // 重力等级 (1..RR_GRAVITY_LEVELS)
+    int lastObstacleRight;  // 最近生成的障碍物的右边缘 (随障碍物移动)
+    int lastObstacleNeed;   // 它需要的动作 (RRNeed)
+    int fairMode;           // RRFairMode
+    int ghost;              // 1 = 恐龙不参与碰撞 (离线扫描用，回收、计分、加速照常)
+    int repairedSpawns;     // 修复过的生成次数
+    int deferredSpawns;     // 修不了、推迟了的生成次数
+    int unfairSpawns;       // RR_FAIR_REPORT 下过不去的生成次数
+    int firstUnfairTick;    // 第一次出现过不去的生成的步数，没有为 -1
+    RRRng spawnRng;         // 障碍物生成用的随机数流
+    RRRng cloudRng;         // 云朵用的随机数流
+} RRWorld;
+
+// --- 每一步的输入 ---
+typedef struct {
+    int jump;               // 本步按下跳跃 (VK_SPACE 按下沿)
+    int duck;               // 本步下蹲键处于按住状态 (VK_DOWN)
+} RRInput;
+
+// --- 一步里恐龙扫过的范围 (rrStepMove 给出，碰撞检测用) ---
+typedef struct {
+    int prevY;              // 步开始时的 y (这一步换了姿态则取结束时的 y)
+    int speed;              // 这一步障碍物移动的距离
+} RRStepSweep;
+
+typedef struct {
+    int x0, y0, x1, y1;     // [x0, x1) x [y0, y1)
+} RRSweepBox;
+
+// --- 配置数据 ---
+extern GameConfig levelConfigs[LEVEL_COUNT];
+extern CharacterConfig charConfigs[CHAR_COUNT];
+
+// --- 函数声明 ---
+void rrInitWorld(RRWorld* w, CharacterType charType, DifficultyLevel level, unsigned long long seed);
+void rrStep(RRWorld* w, const RRInput* in);       // 处理输入并推进一步
+// rrStep 拆成两半，供多局同步推进的批量模拟在中间一起做碰撞粗测:
+// rrStepMove 处理输入、移动恐龙和障碍物，已结束的局返回 0 (什么都不做)；
+// rrStepFinish 检测碰撞并完成这一步，collide = 0 表示调用方已确认粗测盒碰不到任何障碍物
+int rrStepMove(RRWorld* w, const RRInput* in, RRStepSweep* sweep);
+void rrStepFinish(RRWorld* w, const RRStepSweep* sweep, int collide);
+// 切换到节拍模式 (rrInitWorld 之后、第一次 rrStep 之前调用)，步数 0 = 音乐开始
+void rrSetBeatTrack(RRWorld* w, const int* ticks, int count, int loopTicks);
+
+// --- 起跳轨迹查询 ---
+const RRJumpTrack* rrJumpTrack(CharacterType c, int gravityLevel);
+// 不再按键的话还有几步落地: 0 = 已在地面，-1 = 悬停不会落地
+int rrLandingTicks(const RRWorld* w);
+
+// --- 状态哈希 (影响玩法的全部字段，跨平台比对用，见 rr_sync_tool) ---
+uint64_t rrWorldHash(const RRWorld* w);
+
+// --- 公平性检查 (表由起跳轨迹预先算好，查询 O(1)) ---
+// 单独一个障碍物 (坐标同 RRObstaclePool) 需要的动作 (RRNeed)
+int rrObstacleNeed(CharacterType c, int gravityLevel, int speed, int y, int width, int height);
+// 上一个障碍物需要 prevNeed，它离开恐龙后再走 gapPixels 这一个就碰到恐龙，
+// 这一个 (需要 need，顶部离地 top) 能否接着通过
+int rrSequenceFair(CharacterType c, int gravityLevel, int speed, int prevNeed, int gapPixels, int need, int top);
+
+// --- 扫掠碰撞 ---
+// 盒子 A 不动，盒子 B 在一步内匀速移动 (dx, dy) (即 B 相对 A 的位移)，坐标取步开始时
+// 两者在 t∈[0,1] 内有重叠 (与静态检测一样用严格不等号) 返回 1，并给出首次接触时刻
+int rrSweepAABB(int ax, int ay, int aw, int ah,
+                int bx, int by, int bw, int bh,
+                int dx, int dy, RRTime* toi);
+static inline int rrTimeLess(RRTime a, RRTime b) {
+    return (long long)a.num * b.den < (long long)b.num * a.den;
+}
+
+// 粗测盒: 恐龙整步扫过的包围盒 (向左加宽 speed 抵消障碍物的移动)，对障碍物移动后的位置
+// (rrStepMove 之后调用；每次现算，不存进 RRStepSweep: 存了再逐个读回会卡在存储转发上)
+static inline RRSweepBox rrStepSweepBox(const RRWorld* w, const RRStepSweep* s) {
+    const Dino* d = &w->dino;
+    RRSweepBox b;
+    b.x0 = d->x - s->speed;
+    b.x1 = d->x + d->width;
+    b.y0 = (s->prevY < d->y) ? s->prevY : d->y;
+    b.y1 = ((s->prevY > d->y) ? s->prevY : d->y) + d->height;
+    return b;
+}
+
+// --- 障碍物池操作 ---
+// 追加一个障碍物，返回下标；池满返回 -1
+static inline int rrObstacleSpawn(RRObstaclePool* p) {
+    if (p->count >= MAX_OBSTACLES_ON_SCREEN) return -1;
+    int i = p->count++;
+    p->id[i] = p->nextId++;
+    return i;
+}
+
+// 回收下标 i，用最后一个补位 (调用方倒序遍历即可边遍历边回收)
+static inline void rrObstacleRetire(RRObstaclePool* p, int i) {
+    int last = --p->count;
+    if (i != last) {
+        p->x[i] = p->x[last];
+        p->y[i] = p->y[last];
+        p->width[i] = p->width[last];
+        p->height[i] = p->height[last];
+        p->type[i] = p->type[last];
+        p->id[i] = p->id[last];
+    }
+}
+
+#endif
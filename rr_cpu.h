@@ -0,0 +1,80 @@
+/*
+ * 文件名: rr_cpu.h
+ * 描述: CPU 指令集检测，供 SIMD 内核在运行时选择实现
+ *       x86 上检测 SSE2 / AVX2 (含操作系统是否保存 YMM 寄存器)，其他平台只有标量版本
+ *       SIMD 函数用 RR_TARGET("avx2") 单独开指令集，整个程序不需要 -mavx2
+ */
+#ifndef RR_CPU_H
+#define RR_CPU_H
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define RR_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define RR_TARGET(isa) __attribute__((target(isa)))
+#else
+#define RR_TARGET(isa)
+#endif
+
+// --- SIMD 级别 ---
+typedef enum {
+    RR_SIMD_SCALAR = 0,
+    RR_SIMD_SSE2 = 1,
+    RR_SIMD_AVX2 = 2,
+    RR_SIMD_COUNT
+} RRSimdLevel;
+
+static inline const char* rrSimdName(int level) {
+    static const char* names[RR_SIMD_COUNT] = {"scalar", "sse2", "avx2"};
+    return (level >= 0 && level < RR_SIMD_COUNT) ? names[level] : "?";
+}
+
+// 当前 CPU 支持的最高级别
+static inline int rrCpuSimdLevel() {
+#if defined(RR_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    int level = (info[3] & (1 << 26)) ? RR_SIMD_SSE2 : RR_SIMD_SCALAR;
+    int osxsave = (info[2] & (1 << 27)) != 0;
+    int avx = (info[2] & (1 << 28)) != 0;
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6) {
+        __cpuidex(info, 7, 0);
+        if (info[1] & (1 << 5)) level = RR_SIMD_AVX2;
+    }
+    return level;
+#elif defined(RR_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return RR_SIMD_AVX2;
+    if (__builtin_cpu_supports("sse2")) return RR_SIMD_SSE2;
+    return RR_SIMD_SCALAR;
+#else
+    return RR_SIMD_SCALAR;
+#endif
+}
+
+// 最低置位的下标 (bits != 0)，用于遍历碰撞掩码
+static inline int rrLowestBit(unsigned int bits) {
+#if defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward(&i, bits);
+    return (int)i;
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(bits);
+#else
+    int i = 0;
+    while (!(bits & 1)) {
+        bits >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+#endif
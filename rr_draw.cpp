@@ -0,0 +1,737 @@
+/*
+ * 文件名: rr_draw.cpp
+ * 描述: 游戏各画面的绘制 (从 new.cpp 移出)，EasyX 调用换成 rr_render 的同名图元
+ */
+#include <math.h>
+#include <stdio.h>
+
+#include "rr_draw.h"
+
+// --- 函数声明 ---
+static void drawMenu(RRRenderer* r, RRScene* s);
+static void drawCharSelect(RRRenderer* r, RRScene* s);
+static void drawLevelSelect(RRRenderer* r, RRScene* s);
+static void drawPlayingState(RRRenderer* r, RRScene* s);
+static void drawGameOver(RRRenderer* r, RRScene* s);
+static void drawDino(RRRenderer* r, RRScene* s);
+static void drawGround(RRRenderer* r, RRScene* s);
+static void drawObstacles(RRRenderer* r, RRScene* s);
+static void drawClouds(RRRenderer* r, RRScene* s);
+static void drawScore(RRRenderer* r, RRScene* s);
+static void drawNightSky(RRRenderer* r, RRScene* s);
+static void drawButton(RRRenderer* r, int x, int y, int width, int height, const char* text, int selected);
+static void drawCharPreview(RRRenderer* r, int x, int y, CharacterType type, int selected);
+static void drawLevelPreview(RRRenderer* r, int x, int y, DifficultyLevel level, int selected);
+
+// --- 静止背景 (画进图层缓存，见 rr_layer) ---
+enum {
+    LAYER_MENU,
+    LAYER_CHAR_SELECT,
+    LAYER_LEVEL_SELECT,
+    LAYER_GAME,
+    LAYER_GAME_OVER
+};
+
+// --- HUD 文字 (每行一个 rr_hud 的槽，数值变了才重画) ---
+enum {
+    HUD_SCORE,
+    HUD_HIGH_SCORE,
+    HUD_SPEED,
+    HUD_LIVES,
+    HUD_CHARACTER,
+    HUD_LEVEL,
+    HUD_AUTOPLAY
+};
+
+static void paintMenuBackground(RRRenderer* r, int theme, int width, int height);
+static void paintCharSelectBackground(RRRenderer* r, int theme, int width, int height);
+static void paintLevelSelectBackground(RRRenderer* r, int theme, int width, int height);
+static void paintGameBackground(RRRenderer* r, int theme, int width, int height);
+static void paintGameOverBackground(RRRenderer* r, int theme, int width, int height);
+
+// --- 画面分发 (对应原来的 renderGame) ---
+void rrDrawScene(RRRenderer* r, RRScene* s) {
+    switch (s->state) {
+        case STATE_MENU:
+            drawMenu(r, s);
+            break;
+        case STATE_CHAR_SELECT:
+            drawCharSelect(r, s);
+            break;
+        case STATE_LEVEL_SELECT:
+            drawLevelSelect(r, s);
+            break;
+        case STATE_GAME:
+            drawPlayingState(r, s);
+            break;
+        case STATE_GAME_OVER:
+            drawGameOver(r, s);
+            break;
+        case STATE_EXIT:
+            // 退出游戏
+            rrClear(r);
+            break;
+    }
+}
+
+// --- 渲染插值 ---
+static int lerpInt(int a, int b, double alpha) {
+    return a + (int)((b - a) * alpha);
+}
+
+void rrSceneInterpolate(RRScene* s, const RRWorld* prev, const RRWorld* cur, double alpha) {
+    s->world = *cur;
+    // 地面和障碍物一样在上一步和当前步之间插值 (alpha = 1 时正好是当前步)
+    s->scroll = (cur->frameCount - 1) * cur->gameSpeed + (int)(cur->gameSpeed * alpha);
+    s->skyScroll = (cur->frameCount - 1) * 4 + (int)(4 * alpha);
+    
+    // 恐龙: 高度变化(下蹲)时直接用当前状态
+    if (prev->dino.height == cur->dino.height) {
+        s->world.dino.y = lerpInt(prev->dino.y, cur->dino.y, alpha);
+    }
+    
+    // 落点: 恐龙不动、地面左移，落地那一步踩到的地面现在在前方 ticks * speed 处，和障碍物一样插值
+    int landing = rrLandingTicks(cur);
+    s->landingX = -1;
+    if (landing > 0) {
+        s->landingX = cur->dino.x + lerpInt((landing + 1) * cur->gameSpeed, landing * cur->gameSpeed, alpha);
+    }
+    
+    // 障碍物: 按 id 找上一步的同一个障碍物 (补位只会把元素往前挪，从 i 往后找)
+    const RRObstaclePool* a = &prev->obstacles;
+    const RRObstaclePool* b = &cur->obstacles;
+    for (int i = 0; i < b->count; i++) {
+        for (int j = i; j < a->count; j++) {
+            if (a->id[j] == b->id[i]) {
+                s->world.obstacles.x[i] = lerpInt(a->x[j], b->x[i], alpha);
+                break;
+            }
+        }
+    }
+    
+    // 云朵: 回绕到右边时不插值
+    for (int i = 0; i < cur->cloudCount; i++) {
+        const Cloud* pa = &prev->clouds[i];
+        const Cloud* pb = &cur->clouds[i];
+        if (pb->x <= pa->x) {
+            s->world.clouds[i].x = lerpInt(pa->x, pb->x, alpha);
+        }
+    }
+}
+
+// --- 星空 ---
+// 星星只在生成时取一次随机数，画的时候按层设一次颜色，再把表里的点画出来
+#define STAR_SEED_MENU 0x5354415231ull
+#define STAR_SEED_NIGHT 0x5354415232ull
+
+static const RRColor starColors[RR_STAR_DEPTHS] = {
+    RR_RGB(150, 150, 120), RR_RGB(210, 210, 165), RR_RGB(255, 255, 200)
+};
+static const int starRadius[RR_STAR_DEPTHS] = {1, 1, 2};
+static const int starShift[RR_STAR_DEPTHS] = {4, 3, 2};    // 视差: skyScroll 右移，分别每步 1/4、1/2、1 像素
+
+// count 颗星星撒在 width x height 里，远的多近的少 (每层依次为上一层的一半左右)
+static void buildStarfield(RRStarfield* f, int count, int width, int height, unsigned long long seed) {
+    RRRng rng;
+    rrRngSeed(&rng, seed, RR_STREAM_VISUAL);
+    if (count > RR_STAR_MAX) count = RR_STAR_MAX;
+
+    int n = 0;
+    for (int d = 0; d < RR_STAR_DEPTHS; d++) {
+        f->depthStart[d] = n;
+        int layer = (d == RR_STAR_DEPTHS - 1) ? count - n : (count - n) * 4 / 7;
+        for (int i = 0; i < layer; i++, n++) {
+            f->x[n] = (short)rrRngRange(&rng, width);
+            f->y[n] = (short)rrRngRange(&rng, height);
+        }
+    }
+    f->depthStart[RR_STAR_DEPTHS] = n;
+    f->count = n;
+}
+
+// 按 scroll (1/4 像素) 往左卷动，出了左边从右边回来
+static void drawStarfield(RRRenderer* r, const RRStarfield* f, int scroll) {
+    for (int d = 0; d < RR_STAR_DEPTHS; d++) {
+        int offset = (scroll >> starShift[d]) % WIN_WIDTH;
+        int radius = starRadius[d];
+        rrSetFillColor(r, starColors[d]);
+        for (int i = f->depthStart[d]; i < f->depthStart[d + 1]; i++) {
+            int x = f->x[i] - offset;
+            if (x < 0) x += WIN_WIDTH;
+            rrSolidCircle(r, x, f->y[i], radius);
+        }
+    }
+}
+
+// --- 绘制主菜单 ---
+// 菜单时世界不推进，星星不动，直接画进背景图层
+static void paintMenuBackground(RRRenderer* r, int, int width, int height) {
+    // 渐变背景
+    for (int i = 0; i < height; i++) {
+        int red = 30 + i * 20 / height;
+        int green = 30 + i * 40 / height;
+        int blue = 50 + i * 60 / height;
+        rrSetLineColor(r, RR_RGB(red, green, blue));
+        rrLine(r, 0, i, width, i);
+    }
+
+    // 星空
+    RRStarfield stars;
+    buildStarfield(&stars, 100, width, height, STAR_SEED_MENU);
+    drawStarfield(r, &stars, 0);
+}
+
+static void drawMenu(RRRenderer* r, RRScene* s) {
+    // 绘制渐变背景和星空
+    rrLayerDraw(s->layers, r, LAYER_MENU, 0, paintMenuBackground);
+    
+    // 绘制标题
+    rrSetTextColor(r, RR_RGB(100, 255, 100));
+    rrSetTextHeight(r, 80);
+    rrText(r, WIN_WIDTH / 2 - 200, WIN_HEIGHT / 4 - 50, "DINO RUN");
+    
+    // 绘制装饰性恐龙 (边框一直是渐变最底一行的颜色，背景进了图层后要自己设置)
+    int bottom = WIN_HEIGHT - 1;
+    rrSetFillColor(r, RR_RGB(80, 180, 80));
+    rrSetLineColor(r, RR_RGB(30 + bottom * 20 / WIN_HEIGHT, 30 + bottom * 40 / WIN_HEIGHT, 50 + bottom * 60 / WIN_HEIGHT));
+    for (int i = 0; i < 3; i++) {
+        int x = 150 + i * 200;
+        int y = WIN_HEIGHT / 2 - 50 + 20 * sin(s->world.frameCount * 0.05 + i);
+        rrFillRect(r, x - 20, y, x + 20, y + 80);
+        rrFillRect(r, x - 10, y - 15, x + 10, y + 10);
+    }
+    
+    // 绘制菜单选项
+    drawButton(r, WIN_WIDTH / 2 - 100, WIN_HEIGHT / 2 + 100, 200, 50, "开始游戏", 1);
+    
+    rrSetTextColor(r, RR_RGB(200, 200, 255));
+    rrSetTextHeight(r, 20);
+    rrText(r, WIN_WIDTH / 2 - 150, WIN_HEIGHT - 80, "按空格键开始游戏");
+    rrText(r, WIN_WIDTH / 2 - 120, WIN_HEIGHT - 50, "按ESC键退出游戏");
+    rrText(r, WIN_WIDTH / 2 - 120, WIN_HEIGHT - 110, "按R键回放上一局");
+    rrText(r, 20, 20, s->autoplay ? "按A键关闭自动驾驶" : "按A键开启自动驾驶");
+    
+    // 绘制最高分
+    char scoreText[100];
+    sprintf(scoreText, "历史最高分: %d", s->highScore);
+    rrSetTextColor(r, RR_RGB(255, 255, 100));
+    rrSetTextHeight(r, 25);
+    rrText(r, WIN_WIDTH / 2 - 100, WIN_HEIGHT / 2 + 170, scoreText);
+}
+
+// --- 绘制角色选择界面 ---
+static void paintCharSelectBackground(RRRenderer* r, int, int width, int height) {
+    rrSetFillColor(r, RR_RGB(40, 40, 80));
+    rrSolidRect(r, 0, 0, width, height);
+    
+    // 标题
+    rrSetTextColor(r, RR_RGB(255, 255, 200));
+    rrSetTextHeight(r, 50);
+    rrText(r, width / 2 - 150, 50, "选择角色");
+    
+    // 控制提示
+    rrSetTextColor(r, RR_RGB(200, 200, 255));
+    rrSetTextHeight(r, 20);
+    rrText(r, width / 2 - 200, height - 150, "← → 键选择角色");
+    rrText(r, width / 2 - 150, height - 120, "空格键确认选择");
+    rrText(r, width / 2 - 150, height - 90, "ESC键返回主菜单");
+}
+
+static void drawCharSelect(RRRenderer* r, RRScene* s) {
+    // 绘制背景、标题和控制提示
+    rrLayerDraw(s->layers, r, LAYER_CHAR_SELECT, 0, paintCharSelectBackground);
+    
+    // 绘制角色预览
+    int startX = WIN_WIDTH / 2 - 250;
+    for (int i = 0; i < CHAR_COUNT; i++) {
+        int x = startX + i * 250;
+        int y = WIN_HEIGHT / 2 - 50;
+        drawCharPreview(r, x, y, (CharacterType)i, s->selectedChar == i);
+    }
+    
+    // 绘制当前角色信息
+    CharacterConfig* config = &charConfigs[s->selectedChar];
+    rrSetTextColor(r, RR_RGB(255, 255, 100));
+    rrSetTextHeight(r, 25);
+    rrText(r, WIN_WIDTH / 2 - 100, WIN_HEIGHT - 200, config->name);
+    
+    // 绘制角色属性
+    rrSetTextColor(r, RR_RGB(200, 255, 200));
+    rrSetTextHeight(r, 18);
+    rrText(r, WIN_WIDTH / 2 - 200, WIN_HEIGHT - 250, "速度: ");
+    rrText(r, WIN_WIDTH / 2 - 200, WIN_HEIGHT - 220, "跳跃: ");
+    rrText(r, WIN_WIDTH / 2 - 200, WIN_HEIGHT - 190, "生命: ");
+    
+    char buffer[50];
+    sprintf(buffer, "%.1fx", config->speedMultiplier);
+    rrText(r, WIN_WIDTH / 2 - 120, WIN_HEIGHT - 250, buffer);
+    
+    sprintf(buffer, "%.1fx", config->jumpMultiplier);
+    rrText(r, WIN_WIDTH / 2 - 120, WIN_HEIGHT - 220, buffer);
+    
+    sprintf(buffer, "%d", (s->selectedChar == CHAR_TANK) ? 3 : 1);
+    rrText(r, WIN_WIDTH / 2 - 120, WIN_HEIGHT - 190, buffer);
+}
+
+// --- 绘制难度选择界面 ---
+static void paintLevelSelectBackground(RRRenderer* r, int, int width, int height) {
+    rrSetFillColor(r, RR_RGB(40, 80, 40));
+    rrSolidRect(r, 0, 0, width, height);
+    
+    // 标题
+    rrSetTextColor(r, RR_RGB(255, 255, 200));
+    rrSetTextHeight(r, 50);
+    rrText(r, width / 2 - 150, 50, "选择难度");
+    
+    // 控制提示
+    rrSetTextColor(r, RR_RGB(200, 200, 255));
+    rrSetTextHeight(r, 20);
+    rrText(r, width / 2 - 200, height - 150, "← → 键选择难度");
+    rrText(r, width / 2 - 150, height - 120, "空格键开始游戏");
+    rrText(r, width / 2 - 150, height - 90, "ESC键返回角色选择");
+}
+
+static void drawLevelSelect(RRRenderer* r, RRScene* s) {
+    // 绘制背景、标题和控制提示
+    rrLayerDraw(s->layers, r, LAYER_LEVEL_SELECT, 0, paintLevelSelectBackground);
+    
+    // 绘制当前选择的角色
+    CharacterConfig* charConfig = &charConfigs[s->selectedChar];
+    rrSetTextColor(r, RR_RGB(charConfig->colorR, charConfig->colorG, charConfig->colorB));
+    rrSetTextHeight(r, 25);
+    rrText(r, 100, 120, charConfig->name);
+    drawCharPreview(r, 50, 150, s->selectedChar, 1);
+    
+    // 绘制难度预览
+    int startX = WIN_WIDTH / 2 - 200;
+    for (int i = 0; i < LEVEL_COUNT; i++) {
+        int x = startX + i * 200;
+        int y = WIN_HEIGHT / 2 - 50;
+        drawLevelPreview(r, x, y, (DifficultyLevel)i, s->selectedLevel == i);
+    }
+    
+    // 绘制当前难度信息
+    GameConfig* config = &levelConfigs[s->selectedLevel];
+    rrSetTextColor(r, RR_RGB(255, 255, 100));
+    rrSetTextHeight(r, 25);
+    rrText(r, WIN_WIDTH / 2 - 100, WIN_HEIGHT - 200, config->name);
+    
+    // 绘制难度参数
+    rrSetTextColor(r, RR_RGB(200, 255, 200));
+    rrSetTextHeight(r, 18);
+    rrText(r, WIN_WIDTH / 2 - 200, WIN_HEIGHT - 250, "速度: ");
+    rrText(r, WIN_WIDTH / 2 - 200, WIN_HEIGHT - 220, "障碍物: ");
+    rrText(r, WIN_WIDTH / 2 - 200, WIN_HEIGHT - 190, "重力: ");
+    
+    char buffer[50];
+    sprintf(buffer, "%.1fx", config->speed / 1000.0);
+    rrText(r, WIN_WIDTH / 2 - 120, WIN_HEIGHT - 250, buffer);
+    
+    sprintf(buffer, "%d%%", config->obstacleDensity);
+    rrText(r, WIN_WIDTH / 2 - 120, WIN_HEIGHT - 220, buffer);
+    
+    sprintf(buffer, "%d级", config->gravity);
+    rrText(r, WIN_WIDTH / 2 - 120, WIN_HEIGHT - 190, buffer);
+}
+
+// --- 绘制游戏进行界面 ---
+static RRColor groundColorOf(int themeColor) {
+    switch (themeColor) {
+        case 0: return RR_RGB(220, 200, 170);  // 绿色主题
+        case 1: return RR_RGB(200, 220, 240);  // 蓝色主题
+        case 2: return RR_RGB(60, 60, 70);     // 夜晚主题
+        default: return RR_RGB(220, 200, 170);
+    }
+}
+
+// 天空和地面的底色 (云和星星都在地平线以上，地面先画也不会被它们盖住)
+static void paintGameBackground(RRRenderer* r, int theme, int width, int height) {
+    if (theme == 2) {  // 夜晚
+        rrSetFillColor(r, RR_RGB(20, 20, 40));
+    } else if (theme == 1) {  // 蓝色主题
+        rrSetFillColor(r, RR_RGB(150, 200, 255));
+    } else {  // 绿色主题
+        rrSetFillColor(r, RR_RGB(180, 230, 200));
+    }
+    rrSolidRect(r, 0, 0, width, height);
+    
+    rrSetFillColor(r, groundColorOf(theme));
+    rrSolidRect(r, 0, GROUND_Y, width, height);
+}
+
+static void drawPlayingState(RRRenderer* r, RRScene* s) {
+    // 根据主题绘制背景
+    GameConfig* config = &levelConfigs[s->selectedLevel];
+    int themeColor = config->themeColor;
+    
+    rrLayerDraw(s->layers, r, LAYER_GAME, themeColor, paintGameBackground);
+    if (themeColor == 2) {  // 夜晚
+        drawNightSky(r, s);
+    }
+    
+    // 绘制游戏元素
+    drawClouds(r, s);
+    drawGround(r, s);
+    drawObstacles(r, s);
+    drawDino(r, s);
+    drawScore(r, s);
+}
+
+// --- 绘制游戏结束界面 ---
+#define PANEL_WIDTH 500
+#define PANEL_HEIGHT 300
+
+// 黑色背景、面板和固定的文字
+static void paintGameOverBackground(RRRenderer* r, int, int width, int height) {
+    // 半透明黑色背景
+    rrSetFillColor(r, RR_RGB(0, 0, 0));
+    rrSolidRect(r, 0, 0, width, height);
+    
+    // 游戏结束面板
+    rrSetFillColor(r, RR_RGB(40, 40, 70));
+    int panelX = (width - PANEL_WIDTH) / 2;
+    int panelY = (height - PANEL_HEIGHT) / 2;
+    
+    rrFillRect(r, panelX, panelY, panelX + PANEL_WIDTH, panelY + PANEL_HEIGHT);
+    
+    // 面板边框
+    rrSetLineColor(r, RR_RGB(100, 100, 150));
+    rrRect(r, panelX, panelY, panelX + PANEL_WIDTH, panelY + PANEL_HEIGHT);
+    rrRect(r, panelX + 5, panelY + 5, panelX + PANEL_WIDTH - 5, panelY + PANEL_HEIGHT - 5);
+    
+    // 游戏结束文本
+    rrSetTextColor(r, RR_RGB(255, 100, 100));
+    rrSetTextHeight(r, 50);
+    rrText(r, panelX + 120, panelY + 30, "游戏结束");
+    
+    // 重新开始提示
+    rrSetTextColor(r, RR_RGB(200, 255, 200));
+    rrSetTextHeight(r, 20);
+    rrText(r, panelX + 120, panelY + 230, "按空格键返回主菜单");
+    rrText(r, panelX + 140, panelY + 260, "按ESC键退出游戏");
+}
+
+static void drawGameOver(RRRenderer* r, RRScene* s) {
+    rrLayerDraw(s->layers, r, LAYER_GAME_OVER, 0, paintGameOverBackground);
+    int panelX = (WIN_WIDTH - PANEL_WIDTH) / 2;
+    int panelY = (WIN_HEIGHT - PANEL_HEIGHT) / 2;
+    
+    // 分数显示
+    char scoreText[100];
+    sprintf(scoreText, "分数: %d", s->world.score);
+    rrSetTextColor(r, RR_RGB(255, 255, 200));
+    rrSetTextHeight(r, 30);
+    rrText(r, panelX + 150, panelY + 100, scoreText);
+    
+    // 最高分显示
+    if (s->newRecord) {
+        rrSetTextColor(r, RR_RGB(255, 255, 100));
+        rrText(r, panelX + 150, panelY + 140, "新纪录!");
+    }
+    
+    sprintf(scoreText, "最高分: %d", s->highScore);
+    rrSetTextColor(r, RR_RGB(200, 200, 255));
+    rrText(r, panelX + 150, panelY + 180, scoreText);
+}
+
+// --- 绘制按钮 ---
+static void drawButton(RRRenderer* r, int x, int y, int width, int height, const char* text, int selected) {
+    // 按钮背景
+    if (selected) {
+        rrSetFillColor(r, RR_RGB(100, 200, 100));
+    } else {
+        rrSetFillColor(r, RR_RGB(80, 160, 80));
+    }
+    rrSolidRect(r, x, y, x + width, y + height);
+    
+    // 按钮边框
+    if (selected) {
+        rrSetLineColor(r, RR_RGB(150, 255, 150));
+    } else {
+        rrSetLineColor(r, RR_RGB(120, 200, 120));
+    }
+    rrRect(r, x, y, x + width, y + height);
+    
+    // 按钮文字
+    rrSetTextColor(r, RR_RGB(255, 255, 255));
+    rrSetTextHeight(r, (int)(height * 0.6));
+    int textWidth = rrTextWidth(r, text);
+    int textHeight = rrTextHeight(r);
+    rrText(r, x + (width - textWidth) / 2, y + (height - textHeight) / 2, text);
+}
+
+// --- 绘制角色预览 ---
+static void drawCharPreview(RRRenderer* r, int x, int y, CharacterType type, int selected) {
+    CharacterConfig* config = &charConfigs[type];
+    
+    // 背景框
+    if (selected) {
+        rrSetFillColor(r, RR_RGB(config->colorR + 50, config->colorG + 50, config->colorB + 50));
+        rrSetLineColor(r, RR_RGB(255, 255, 100));
+    } else {
+        rrSetFillColor(r, RR_RGB(config->colorR, config->colorG, config->colorB));
+        rrSetLineColor(r, RR_RGB(200, 200, 200));
+    }
+    
+    rrFillRect(r, x - 60, y - 60, x + 60, y + 100);
+    rrRect(r, x - 60, y - 60, x + 60, y + 100);
+    
+    if (selected) {
+        rrRect(r, x - 55, y - 55, x + 55, y + 95);
+    }
+    
+    // 绘制恐龙
+    rrSetFillColor(r, RR_RGB(config->colorR, config->colorG, config->colorB));
+    rrFillRect(r, x - 15, y, x + 15, y + 70);
+    rrFillRect(r, x - 10, y - 15, x + 10, y + 10);
+    
+    // 眼睛
+    rrSetFillColor(r, RR_RGB(255, 255, 255));
+    rrSolidCircle(r, x - 5, y - 5, 4);
+    rrSetFillColor(r, RR_RGB(0, 0, 0));
+    rrSolidCircle(r, x - 4, y - 5, 2);
+    
+    // 角色名称
+    rrSetTextColor(r, RR_RGB(255, 255, 255));
+    rrSetTextHeight(r, 20);
+    rrText(r, x - rrTextWidth(r, config->name) / 2, y + 80, config->name);
+}
+
+// --- 绘制难度预览 ---
+static void drawLevelPreview(RRRenderer* r, int x, int y, DifficultyLevel level, int selected) {
+    GameConfig* config = &levelConfigs[level];
+    
+    // 根据难度设置颜色
+    RRColor bgColor, borderColor;
+    switch (level) {
+        case LEVEL_EASY:
+            bgColor = RR_RGB(100, 200, 100);
+            borderColor = selected ? RR_RGB(150, 255, 150) : RR_RGB(80, 180, 80);
+            break;
+        case LEVEL_NORMAL:
+            bgColor = RR_RGB(100, 150, 255);
+            borderColor = selected ? RR_RGB(150, 200, 255) : RR_RGB(80, 130, 230);
+            break;
+        case LEVEL_HARD:
+            bgColor = RR_RGB(255, 100, 100);
+            borderColor = selected ? RR_RGB(255, 150, 150) : RR_RGB(230, 80, 80);
+            break;
+        default:
+            bgColor = RR_RGB(150, 150, 150);
+            borderColor = RR_RGB(200, 200, 200);
+    }
+    
+    // 背景框
+    rrSetFillColor(r, bgColor);
+    rrSetLineColor(r, borderColor);
+    rrFillRect(r, x - 70, y - 70, x + 70, y + 70);
+    rrRect(r, x - 70, y - 70, x + 70, y + 70);
+    
+    if (selected) {
+        rrRect(r, x - 65, y - 65, x + 65, y + 65);
+    }
+    
+    // 难度图标
+    rrSetFillColor(r, RR_RGB(255, 255, 200));
+    if (level == LEVEL_EASY) {
+        // 简单的仙人掌
+        rrFillRect(r, x - 10, y - 20, x + 10, y + 20);
+        rrSetLineColor(r, RR_RGB(80, 140, 80));
+        rrLine(r, x, y - 15, x, y + 15);
+    } else if (level == LEVEL_NORMAL) {
+        // 中等的仙人掌和鸟
+        rrFillRect(r, x - 15, y - 25, x - 5, y + 10);
+        rrSetFillColor(r, RR_RGB(200, 100, 100));
+        rrFillEllipse(r, x + 5, y - 10, x + 25, y + 10);
+    } else {
+        // 困难的仙人掌、鸟和闪电
+        rrFillRect(r, x - 20, y - 30, x - 10, y + 15);
+        rrSetFillColor(r, RR_RGB(200, 100, 100));
+        rrFillEllipse(r, x, y - 15, x + 15, y + 5);
+        rrSetFillColor(r, RR_RGB(255, 255, 0));
+        RRPoint points[4] = {{x + 25, y - 25}, {x + 35, y - 15}, {x + 25, y - 5}, {x + 35, y + 5}};
+        rrSolidPolygon(r, points, 4);
+    }
+    
+    // 难度名称
+    rrSetTextColor(r, RR_RGB(255, 255, 255));
+    rrSetTextHeight(r, 25);
+    rrText(r, x - rrTextWidth(r, config->name) / 2, y + 80, config->name);
+}
+
+// --- 游戏核心函数（与之前相同，略作调整） ---
+static void drawNightSky(RRRenderer* r, RRScene* s) {
+    if (s->nightStars.count == 0) {
+        buildStarfield(&s->nightStars, 150, WIN_WIDTH, GROUND_Y - 100, STAR_SEED_NIGHT);
+    }
+    drawStarfield(r, &s->nightStars, s->skyScroll);
+}
+
+static void drawDino(RRRenderer* r, RRScene* s) {
+    const Dino& dino = s->world.dino;
+    CharacterConfig* config = &charConfigs[dino.type];
+    RRColor dinoColor = RR_RGB(config->colorR, config->colorG, config->colorB);
+    RRColor eyeColor = RR_RGB(255, 255, 255);
+    RRColor pupilColor = RR_RGB(0, 0, 0);
+    
+    rrSetFillColor(r, dinoColor);
+    if (dino.isDucking) {
+        // 下蹲状态
+        rrFillRect(r, dino.x, dino.y + 20, dino.x + dino.width, dino.y + dino.height);
+        rrFillRect(r, dino.x + 10, dino.y + 10, dino.x + dino.width - 10, dino.y + 40);
+        
+        rrSetFillColor(r, eyeColor);
+        rrSolidCircle(r, dino.x + 25, dino.y + 20, 5);
+        rrSetFillColor(r, pupilColor);
+        rrSolidCircle(r, dino.x + 26, dino.y + 20, 2);
+        
+        rrSetFillColor(r, dinoColor);
+        if (s->world.frameCount % 20 < 10) {
+            rrFillRect(r, dino.x + 5, dino.y + dino.height - 10, dino.x + 15, dino.y + dino.height);
+            rrFillRect(r, dino.x + 25, dino.y + dino.height - 5, dino.x + 35, dino.y + dino.height);
+        } else {
+            rrFillRect(r, dino.x + 5, dino.y + dino.height - 5, dino.x + 15, dino.y + dino.height);
+            rrFillRect(r, dino.x + 25, dino.y + dino.height - 10, dino.x + 35, dino.y + dino.height);
+        }
+    } else {
+        // 站立/跳跃状态
+        rrFillRect(r, dino.x, dino.y, dino.x + dino.width, dino.y + dino.height);
+        rrFillRect(r, dino.x + 10, dino.y - 15, dino.x + dino.width - 10, dino.y + 10);
+        
+        rrSetFillColor(r, eyeColor);
+        rrSolidCircle(r, dino.x + 25, dino.y - 5, 5);
+        rrSetFillColor(r, pupilColor);
+        rrSolidCircle(r, dino.x + 26, dino.y - 5, 2);
+        
+        rrSetLineColor(r, RR_RGB(0, 0, 0));
+        rrLine(r, dino.x + 30, dino.y, dino.x + 35, dino.y - 5);
+        
+        if (!dino.isJumping) {
+            rrSetFillColor(r, dinoColor);
+            if (s->world.frameCount % 20 < 10) {
+                rrFillRect(r, dino.x + 5, dino.y + dino.height - 10, dino.x + 15, dino.y + dino.height);
+                rrFillRect(r, dino.x + 25, dino.y + dino.height - 5, dino.x + 35, dino.y + dino.height);
+            } else {
+                rrFillRect(r, dino.x + 5, dino.y + dino.height - 5, dino.x + 15, dino.y + dino.height);
+                rrFillRect(r, dino.x + 25, dino.y + dino.height - 10, dino.x + 35, dino.y + dino.height);
+            }
+        }
+    }
+    
+    // 跳跃落点标记
+    if (s->landingX >= 0 && s->landingX < WIN_WIDTH) {
+        rrSetLineColor(r, dinoColor);
+        rrLine(r, s->landingX, GROUND_Y - 2, s->landingX + dino.width, GROUND_Y - 2);
+        rrLine(r, s->landingX, GROUND_Y - 6, s->landingX, GROUND_Y - 2);
+        rrLine(r, s->landingX + dino.width, GROUND_Y - 6, s->landingX + dino.width, GROUND_Y - 2);
+    }
+    
+    // 绘制生命值（如果有）
+    if (dino.lives > 1) {
+        rrSetTextColor(r, RR_RGB(255, 100, 100));
+        rrSetTextHeight(r, 15);
+        char livesText[20];
+        sprintf(livesText, "x%d", dino.lives);
+        rrText(r, dino.x + dino.width + 5, dino.y, livesText);
+    }
+}
+
+// 地面底色在背景图层里，这里只画滚动的纹理和地平线
+static void drawGround(RRRenderer* r, RRScene* s) {
+    GameConfig* config = &levelConfigs[s->selectedLevel];
+    RRColor groundColor = groundColorOf(config->themeColor);
+    
+    // 提取颜色分量
+    int red = RR_RED(groundColor);
+    int green = RR_GREEN(groundColor);
+    int blue = RR_BLUE(groundColor);
+    
+    // 地面纹理
+    rrSetLineColor(r, RR_RGB((int)(red * 0.9), (int)(green * 0.9), (int)(blue * 0.9)));
+    for (int i = -s->scroll % 20; i < WIN_WIDTH; i += 20) {
+        rrLine(r, i, GROUND_Y, i + 10, GROUND_Y + 5);
+    }
+    
+    // 地平线
+    rrSetLineColor(r, RR_RGB((int)(red * 0.8), (int)(green * 0.8), (int)(blue * 0.8)));
+    rrLine(r, 0, GROUND_Y, WIN_WIDTH, GROUND_Y);
+}
+
+static void drawObstacles(RRRenderer* r, RRScene* s) {
+    const RRObstaclePool* obstacles = &s->world.obstacles;
+    for (int i = 0; i < obstacles->count; i++) {
+        int x = obstacles->x[i], y = obstacles->y[i];
+        int width = obstacles->width[i], height = obstacles->height[i];
+
+        if (obstacles->type[i] == 0 || obstacles->type[i] == 1) {
+            rrSetFillColor(r, s->nightMode ? RR_RGB(80, 120, 80) : RR_RGB(100, 160, 100));
+            rrFillRect(r, x, y, x + width, y + height);
+            
+            rrSetLineColor(r, s->nightMode ? RR_RGB(60, 100, 60) : RR_RGB(80, 140, 80));
+            rrLine(r, x + width / 2, y + 5, x + width / 2, y + height - 5);
+            
+            if (obstacles->type[i] == 1) {
+                rrFillRect(r, x - 5, y + 20, x, y + 30);
+                rrFillRect(r, x + width, y + 10, x + width + 5, y + 20);
+            }
+        } else {
+            rrSetFillColor(r, s->nightMode ? RR_RGB(120, 100, 120) : RR_RGB(200, 100, 100));
+            rrFillEllipse(r, x, y, x + width, y + height);
+            
+            rrSetFillColor(r, s->nightMode ? RR_RGB(100, 80, 100) : RR_RGB(180, 80, 80));
+            if (s->world.frameCount % 20 < 10) {
+                rrFillRect(r, x - 5, y + 5, x + 5, y + height - 5);
+            } else {
+                rrFillRect(r, x + width - 5, y + 5, x + width + 5, y + height - 5);
+            }
+            
+            rrSetFillColor(r, RR_RGB(255, 255, 255));
+            rrSolidCircle(r, x + width - 8, y + 5, 3);
+            rrSetFillColor(r, RR_RGB(0, 0, 0));
+            rrSolidCircle(r, x + width - 7, y + 5, 1);
+        }
+    }
+}
+
+static void drawClouds(RRRenderer* r, RRScene* s) {
+    const Cloud* clouds = s->world.clouds;
+    for (int i = 0; i < s->world.cloudCount; i++) {
+        rrSetFillColor(r, s->nightMode ? RR_RGB(100, 100, 120) : RR_RGB(250, 250, 255));
+        rrFillEllipse(r, clouds[i].x, clouds[i].y, clouds[i].x + 40, clouds[i].y + 20);
+        rrFillEllipse(r, clouds[i].x + 15, clouds[i].y - 10, clouds[i].x + 55, clouds[i].y + 15);
+        rrFillEllipse(r, clouds[i].x + 30, clouds[i].y, clouds[i].x + 70, clouds[i].y + 20);
+    }
+}
+
+static void drawScore(RRRenderer* r, RRScene* s) {
+    // 分数
+    rrSetTextColor(r, s->nightMode ? RR_RGB(200, 200, 255) : RR_RGB(80, 80, 120));
+    rrSetTextHeight(r, 20);
+    rrHudValue(s->hud, r, HUD_SCORE, 20, 20, "分数: ", s->world.score);
+    
+    // 最高分
+    rrHudValue(s->hud, r, HUD_HIGH_SCORE, 20, 50, "最高分: ", s->highScore);
+    
+    // 速度
+    rrHudValue(s->hud, r, HUD_SPEED, 20, 80, "速度: ", s->world.gameSpeed);
+    
+    // 生命值（如果有）
+    if (s->world.dino.lives > 1) {
+        rrSetTextColor(r, RR_RGB(255, 100, 100));
+        rrHudValue(s->hud, r, HUD_LIVES, 20, 110, "生命: ", s->world.dino.lives);
+    }
+    
+    // 角色和难度信息
+    CharacterConfig* charConfig = &charConfigs[s->selectedChar];
+    GameConfig* levelConfig = &levelConfigs[s->selectedLevel];
+    
+    rrSetTextColor(r, RR_RGB(charConfig->colorR, charConfig->colorG, charConfig->colorB));
+    rrHudText(s->hud, r, HUD_CHARACTER, WIN_WIDTH - 200, 20, charConfig->name);
+    
+    rrSetTextColor(r, s->nightMode ? RR_RGB(200, 200, 255) : RR_RGB(100, 100, 150));
+    rrHudText(s->hud, r, HUD_LEVEL, WIN_WIDTH - 200, 50, levelConfig->name);
+    
+    if (s->autoplay && !s->replayMode) {
+        rrHudText(s->hud, r, HUD_AUTOPLAY, WIN_WIDTH - 200, 80, "自动驾驶");
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ * 文件名: rr_draw.h
+ * 描述: 游戏各画面的绘制，逻辑来自 new.cpp 的 drawMenu / drawPlayingState / drawDino 等，
+ *       去掉了全局变量，只通过 rr_render 的后端接口画图
+ *       画面需要的全部状态都在 RRScene 里，new.cpp 每帧填好再调 rrDrawScene
+ */
+#ifndef RR_DRAW_H
+#define RR_DRAW_H
+
+#include "rr_core.h"
+#include "rr_hud.h"
+#include "rr_layer.h"
+#include "rr_render.h"
+
+// --- 游戏状态 (画哪个画面) ---
+typedef enum {
+    STATE_MENU,
+    STATE_CHAR_SELECT,
+    STATE_LEVEL_SELECT,
+    STATE_GAME,
+    STATE_GAME_OVER,
+    STATE_EXIT
+} GameState;
+
+// --- 星空: 每个主题生成一次的星星表，按远近分几层视差滚动 ---
+#define RR_STAR_MAX 160
+#define RR_STAR_DEPTHS 3        // 0 = 最远 (最暗、最慢)
+
+typedef struct {
+    int count;                          // 0 = 还没生成
+    int depthStart[RR_STAR_DEPTHS + 1]; // 第 d 层是 [depthStart[d], depthStart[d + 1])，一层只设一次颜色
+    short x[RR_STAR_MAX];
+    short y[RR_STAR_MAX];
+} RRStarfield;
+
+// --- 一帧画面需要的全部状态 ---
+typedef struct {
+    GameState state;
+    CharacterType selectedChar;
+    DifficultyLevel selectedLevel;
+    RRWorld world;          // 本帧实际绘制的插值状态 (rrSceneInterpolate 给出)
+    int scroll;             // 地面纹理的插值滚动距离
+    int skyScroll;          // 星空的插值滚动距离 (1/4 像素，每步固定 4，不随速度变，加速时星星不会跳)
+    int landingX;           // 跳跃落点在地面上的插值位置，-1 = 不画
+    int highScore;
+    int newRecord;          // 游戏结束画面显示 "新纪录!"
+    int nightMode;
+    int autoplay;
+    int replayMode;
+    RRStarfield nightStars; // 夜晚主题的星空，第一次画时生成
+    RRLayerCache* layers;   // 静止背景的图层缓存 (与绘制用的后端配套)，NULL = 每帧直接画
+    RRHud* hud;             // HUD 文字缓存 (同上)，NULL = 每帧直接画字
+} RRScene;
+
+// 在上一步和当前步之间按 alpha (0~1) 插值，渲染帧率与模拟频率无关
+void rrSceneInterpolate(RRScene* s, const RRWorld* prev, const RRWorld* cur, double alpha);
+
+// 画出 s->state 对应的画面 (不 present)，每个画面的背景都盖满整屏，不另外清屏
+void rrDrawScene(RRRenderer* r, RRScene* s);
+
+#endif
@@ -0,0 +1,167 @@
+/*
+ * 文件名: rr_fair_tool.cpp
+ * 描述: 生成公平性离线扫描 (无界面，多线程)
+ *       每个种子跑两遍 "幽灵" 局 (恐龙不参与碰撞 (RRWorld.ghost)，障碍物照常生成、计分、加速):
+ *       RR_FAIR_REPORT 按旧规则生成，统计多少局在 1/5/10 分钟内出现过不去的障碍物 (必死)
+ *       以及必死占全部生成的比例 (判断规则与游戏相同，含 RR_FAIR_SLACK 余量)；
+ *       RR_FAIR_REPAIR 是游戏实际用的规则，统计修复/推迟的频率
+ *       修复后是否真能通过由 rr_bot_tool 独立检查
+ * 编译: g++ -O2 -std=c++11 -pthread rr_fair_tool.cpp rr_core.cpp rr_collide.cpp -o rr_fair_tool
+ * 用法: rr_fair_tool [每组种子数=10000] [线程数=CPU核数] [每局最大步数=36000] [种子=1]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "rr_core.h"
+
+// --- 统计参数 ---
+#define COMBO_COUNT (CHAR_COUNT * LEVEL_COUNT)
+#define MARK_COUNT 3            // 统计 1/5/10 分钟内
+#define RUNS_PER_CHUNK 64       // 每次领取的任务大小
+
+const int markMinutes[MARK_COUNT] = {1, 5, 10};
+
+// --- 单个组合的统计 ---
+typedef struct {
+    long long runs;
+    long long unfairBy[MARK_COUNT];     // 到第几分钟为止出现过必死的局数
+    long long spawns;                   // 旧规则下的生成总数
+    long long unfairSpawns;             // 其中必死的
+    long long repairedSpawns;           // 新规则下修复的生成总数
+    long long deferredSpawns;           // 新规则下推迟的生成总数
+    long long steps;
+} ComboStats;
+
+typedef struct {
+    ComboStats combos[COMBO_COUNT];
+} ThreadStats;
+
+// --- 运行参数 (所有线程只读) ---
+int seedsPerCombo = 10000;
+int threadCount = 0;
+int maxSteps = 36000;        // 60步/秒 下 10 分钟
+unsigned int baseSeed = 1;
+
+std::atomic<long long> nextChunk(0);
+
+// --- 幽灵局: 不按键，恐龙不参与碰撞 ---
+void runGhost(RRWorld* w, CharacterType ch, DifficultyLevel lv, unsigned int seed, int mode) {
+    RRInput input = {0, 0};
+    rrInitWorld(w, ch, lv, seed);
+    w->fairMode = mode;
+    w->ghost = 1;
+    while (!w->gameOver && w->frameCount < maxSteps) {
+        rrStep(w, &input);
+    }
+}
+
+void runOne(ComboStats* stats, CharacterType ch, DifficultyLevel lv, unsigned int seed) {
+    RRWorld world;
+
+    runGhost(&world, ch, lv, seed, RR_FAIR_REPORT);
+    stats->runs++;
+    stats->steps += world.frameCount;
+    stats->spawns += world.obstacles.nextId;
+    stats->unfairSpawns += world.unfairSpawns;
+    for (int i = 0; i < MARK_COUNT; i++) {
+        if (world.firstUnfairTick >= 0 && world.firstUnfairTick < markMinutes[i] * 3600) {
+            stats->unfairBy[i]++;
+        }
+    }
+
+    runGhost(&world, ch, lv, seed, RR_FAIR_REPAIR);
+    stats->repairedSpawns += world.repairedSpawns;
+    stats->deferredSpawns += world.deferredSpawns;
+}
+
+// --- 工作线程: 按块领取任务，只写自己的统计，最后再合并 ---
+void workerMain(ThreadStats* stats) {
+    long long chunksPerCombo = (seedsPerCombo + RUNS_PER_CHUNK - 1) / RUNS_PER_CHUNK;
+    long long totalChunks = chunksPerCombo * COMBO_COUNT;
+
+    for (;;) {
+        long long chunk = nextChunk.fetch_add(1);
+        if (chunk >= totalChunks) break;
+
+        int combo = (int)(chunk / chunksPerCombo);
+        int first = (int)(chunk % chunksPerCombo) * RUNS_PER_CHUNK;
+        int last = first + RUNS_PER_CHUNK;
+        if (last > seedsPerCombo) last = seedsPerCombo;
+
+        CharacterType ch = (CharacterType)(combo / LEVEL_COUNT);
+        DifficultyLevel lv = (DifficultyLevel)(combo % LEVEL_COUNT);
+        for (int run = first; run < last; run++) {
+            // 与 rr_balance 相同的种子规则，两边的局可以对照
+            unsigned int seed = baseSeed + (unsigned int)(combo * seedsPerCombo + run) * 2654435761u;
+            runOne(&stats->combos[combo], ch, lv, seed);
+        }
+    }
+}
+
+// --- 主函数 ---
+int main(int argc, char** argv) {
+    if (argc > 1) seedsPerCombo = atoi(argv[1]);
+    if (argc > 2) threadCount = atoi(argv[2]);
+    if (argc > 3) maxSteps = atoi(argv[3]);
+    if (argc > 4) baseSeed = (unsigned int)strtoul(argv[4], NULL, 10);
+    if (threadCount <= 0) threadCount = (int)std::thread::hardware_concurrency();
+    if (threadCount <= 0) threadCount = 1;
+    if (seedsPerCombo <= 0 || maxSteps <= 0) {
+        printf("用法: rr_fair_tool [每组种子数] [线程数] [每局最大步数] [种子]\n");
+        return 1;
+    }
+
+    std::vector<ThreadStats> stats(threadCount);
+    memset(stats.data(), 0, sizeof(ThreadStats) * threadCount);
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threadCount; i++) {
+        workers.push_back(std::thread(workerMain, &stats[i]));
+    }
+    for (int i = 0; i < threadCount; i++) {
+        workers[i].join();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    // 合并各线程的统计
+    ComboStats total[COMBO_COUNT];
+    memset(total, 0, sizeof(total));
+    long long totalSteps = 0;
+    for (int t = 0; t < threadCount; t++) {
+        for (int c = 0; c < COMBO_COUNT; c++) {
+            const ComboStats* s = &stats[t].combos[c];
+            total[c].runs += s->runs;
+            total[c].spawns += s->spawns;
+            total[c].unfairSpawns += s->unfairSpawns;
+            total[c].repairedSpawns += s->repairedSpawns;
+            total[c].deferredSpawns += s->deferredSpawns;
+            total[c].steps += s->steps;
+            for (int i = 0; i < MARK_COUNT; i++) total[c].unfairBy[i] += s->unfairBy[i];
+            totalSteps += 2 * s->steps;
+        }
+    }
+
+    printf("共 %d 组 x %d 种子, %d 线程, 用时 %.2f 秒, %.1f M步/秒\n",
+           COMBO_COUNT, seedsPerCombo, threadCount, seconds, totalSteps / seconds / 1e6);
+    printf("旧规则下出现必死障碍物的局数比例 / 必死占生成的比例 | 新规则每分钟修复数 / 推迟数\n");
+    for (int c = 0; c < COMBO_COUNT; c++) {
+        const ComboStats* s = &total[c];
+        double minutes = s->steps / 3600.0;
+        printf("%s x %s:", charConfigs[c / LEVEL_COUNT].name, levelConfigs[c % LEVEL_COUNT].name);
+        for (int i = 0; i < MARK_COUNT; i++) {
+            if (markMinutes[i] * 3600 > maxSteps) break;
+            printf(" %d分钟 %.2f%%", markMinutes[i], 100.0 * s->unfairBy[i] / s->runs);
+        }
+        printf(" / %.2f%% | %.2f / %.2f\n", 100.0 * s->unfairSpawns / s->spawns,
+               s->repairedSpawns / minutes, s->deferredSpawns / minutes);
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * 文件名: rr_hud.cpp
+ * 描述: HUD 文字缓存
+ */
+#include <string.h>
+
+#include "rr_hud.h"
+
+void rrHudInit(RRHud* h) {
+    memset(h, 0, sizeof(RRHud));
+}
+
+void rrHudFree(RRHud* h, RRRenderer* r) {
+    for (int i = 0; i < RR_HUD_SLOTS; i++) {
+        if (h->slots[i].image != NULL) rrFreeLayer(r, h->slots[i].image);
+    }
+    memset(h, 0, sizeof(RRHud));
+}
+
+int rrFormatInt(char* dst, int value) {
+    char digits[12];
+    unsigned int u = (value < 0) ? 0u - (unsigned int)value : (unsigned int)value;
+    int n = 0, len = 0;
+    do {
+        digits[n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u != 0);
+    if (value < 0) dst[len++] = '-';
+    while (n > 0) dst[len++] = digits[--n];
+    dst[len] = 0;
+    return len;
+}
+
+// s->text 用 r 当前的字号和颜色重画进图层，建不了图层返回 0
+static int renderSlot(RRHud* h, RRRenderer* r, RRHudSlot* s) {
+    s->valid = 1;
+    s->width = rrTextWidth(r, s->text);
+    s->color = r->textColor;
+    int oldHeight = s->height;
+    s->height = r->textHeight;
+    if (s->width <= 0) return 1;        // 空字符串什么都不画
+
+    if (s->image != NULL && (s->width > s->capacity || s->height != oldHeight)) {
+        rrFreeLayer(r, s->image);
+        s->image = NULL;
+    }
+    if (s->image == NULL) {
+        s->capacity = (s->width + 63) & ~63;
+        s->image = rrCreateLayer(r, s->capacity, s->height);
+        if (s->image == NULL) {
+            s->valid = 0;
+            return 0;
+        }
+    }
+
+    rrBeginLayer(r, s->image);
+    rrText(r, 0, 0, s->text);
+    rrEndLayer(r);
+    h->renders++;
+    return 1;
+}
+
+static void drawSlot(RRHud* h, RRRenderer* r, RRHudSlot* s, int x, int y, int changed) {
+    if (changed && !renderSlot(h, r, s)) {
+        h->fallbacks++;
+        rrText(r, x, y, s->text);
+        return;
+    }
+    if (!changed) h->hits++;
+    if (s->image != NULL && s->width > 0) rrDrawLayer(r, s->image, x, y, s->width, s->height);
+}
+
+void rrHudText(RRHud* h, RRRenderer* r, int slot, int x, int y, const char* text) {
+    if (h == NULL || slot < 0 || slot >= RR_HUD_SLOTS || strlen(text) >= RR_HUD_TEXT_MAX) {
+        rrText(r, x, y, text);
+        return;
+    }
+
+    RRHudSlot* s = &h->slots[slot];
+    int changed = !s->valid || s->label != NULL || s->height != r->textHeight || s->color != r->textColor ||
+                  strcmp(s->text, text) != 0;
+    if (changed) {
+        s->label = NULL;
+        strcpy(s->text, text);
+    }
+    drawSlot(h, r, s, x, y, changed);
+}
+
+void rrHudValue(RRHud* h, RRRenderer* r, int slot, int x, int y, const char* label, int value) {
+    size_t labelLength = strlen(label);
+    if (h == NULL || slot < 0 || slot >= RR_HUD_SLOTS || labelLength + 12 > RR_HUD_TEXT_MAX) {
+        char text[RR_HUD_TEXT_MAX + 12];
+        size_t n = (labelLength < RR_HUD_TEXT_MAX) ? labelLength : RR_HUD_TEXT_MAX;
+        memcpy(text, label, n);
+        rrFormatInt(text + n, value);
+        rrText(r, x, y, text);
+        return;
+    }
+
+    RRHudSlot* s = &h->slots[slot];
+    int changed = !s->valid || s->label != label || s->value != value || s->height != r->textHeight ||
+                  s->color != r->textColor;
+    if (changed) {
+        s->label = label;
+        s->value = value;
+        memcpy(s->text, label, labelLength);
+        rrFormatInt(s->text + labelLength, value);
+    }
+    drawSlot(h, r, s, x, y, changed);
+}
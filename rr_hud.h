@@ -0,0 +1,49 @@
+/*
+ * 文件名: rr_hud.h
+ * 描述: HUD 文字缓存: 每行 HUD 文字占一个槽，画成一块离屏图层，以后每帧整块贴上
+ *       槽记下 (文字, 字号, 颜色)，任何一个变了才重画图层；带数值的行记 (标签, 数值)，
+ *       数值没变连字符串都不拼
+ *       EasyX 的字是不透明底 (黑底) 画的，贴图层和直接画字的像素相同
+ *       一个缓存只给一个后端用 (图层是那个后端的对象)
+ */
+#ifndef RR_HUD_H
+#define RR_HUD_H
+
+#include "rr_render.h"
+
+#define RR_HUD_SLOTS 8
+#define RR_HUD_TEXT_MAX 64
+
+typedef struct {
+    int valid;                  // 0 = 还没画过
+    void* image;                // 后端的图层，NULL = 没建 (空字符串或建不了)
+    int capacity;               // 图层宽度 (按 64 取整，字变长超过了才重建)
+    int width, height;          // 文字的实际大小
+    RRColor color;
+    const char* label;          // rrHudValue 的标签和数值，NULL = rrHudText 的纯文字
+    int value;
+    char text[RR_HUD_TEXT_MAX];
+} RRHudSlot;
+
+typedef struct {
+    RRHudSlot slots[RR_HUD_SLOTS];
+    int renders;                // 统计: 文字画进图层的次数
+    int hits;                   // 统计: 直接贴缓存的次数
+    int fallbacks;              // 统计: 建不了图层，直接画字的次数
+} RRHud;
+
+void rrHudInit(RRHud* h);
+// 释放全部图层 (r 必须是建图层的那个后端)
+void rrHudFree(RRHud* h, RRRenderer* r);
+
+// 用 r 当前的字号和文字颜色在 (x, y) 画 text，和 rrText 的结果相同
+// h 为 NULL 时直接 rrText (不用缓存)
+void rrHudText(RRHud* h, RRRenderer* r, int slot, int x, int y, const char* text);
+
+// 画 label 后接十进制的 value ("分数: 120")，label 须是常量字符串 (按指针比较)
+void rrHudValue(RRHud* h, RRRenderer* r, int slot, int x, int y, const char* label, int value);
+
+// value 写成十进制放进 dst (至少 12 字节)，返回长度；不走 sprintf 的格式解析
+int rrFormatInt(char* dst, int value);
+
+#endif
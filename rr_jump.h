@@ -0,0 +1,77 @@
+/*
+ * 文件名: rr_jump.h
+ * 描述: 起跳轨迹表的编译期生成 (C++11 constexpr)
+ *       按 updateDino 的逐步积分 (速度 += 重力 向零截断成 int，位置 += 速度) 展开
+ *       重力和倍率都是 Q16.16 定点整数，表和运行时的积分只做整数运算，
+ *       与编译器、优化级别、浮点模式无关，各平台逐位一致
+ *       表本身定义在 rr_core.cpp，其他地方通过 rrJumpTrack 查询
+ */
+#ifndef RR_JUMP_H
+#define RR_JUMP_H
+
+#include "rr_core.h"
+
+// --- 角色的跳跃/重力倍率 (Q16.16；charConfigs 里显示用的 float 由它换算，编译期建表读不了可修改的全局表) ---
+constexpr int rrJumpMultipliers[CHAR_COUNT] = {65536, 78643, 58982};       // 1.0 1.2 0.9
+constexpr int rrGravityMultipliers[CHAR_COUNT] = {65536, 52429, 78643};    // 1.0 0.8 1.2
+
+// --- 编译期整数序列 (C++11 没有 std::integer_sequence) ---
+template<int... I> struct RRSeq {};
+template<int N, int... I> struct RRMakeSeq : RRMakeSeq<N - 1, N - 1, I...> {};
+template<int... I> struct RRMakeSeq<0, I...> { typedef RRSeq<I...> type; };
+
+// 每步加到 velocityY 上的重力 (Q16.16): GRAVITY_FIX * 角色倍率，其他等级按比例缩放
+constexpr int rrJumpGravity(int c, int level) {
+    return (int)((long long)GRAVITY_FIX * rrGravityMultipliers[c] >> RR_FIX_SHIFT) * level / RR_GRAVITY_NORMAL;
+}
+
+// 起跳速度: -(JUMP_STRENGTH * 跳跃倍率)，小数部分舍去
+constexpr int rrJumpTakeoff(int c) {
+    return -(JUMP_STRENGTH * rrJumpMultipliers[c] >> RR_FIX_SHIFT);
+}
+
+// 一步的速度更新: v + g 向零截断 (与原来 int += float 的结果相同)
+// updateDino 不在表上时也用它
+constexpr int rrJumpStep(int g, int v) {
+    return (v * RR_FIX_ONE + g) / RR_FIX_ONE;
+}
+
+// 速度为 v、相对站立位置偏移 y 时，再走 t 步后的速度 / 偏移 (负数 = 在空中)
+constexpr int rrJumpV(int g, int v, int t) {
+    return (t == 0) ? v : rrJumpV(g, rrJumpStep(g, v), t - 1);
+}
+constexpr int rrJumpY(int g, int v, int y, int t) {
+    return (t == 0) ? y : rrJumpY(g, rrJumpStep(g, v), y + rrJumpStep(g, v), t - 1);
+}
+
+// 第一个回到地面的步，RR_JUMP_MAX_TICKS 步内没落地为 RR_JUMP_HOVER
+constexpr int rrJumpLanding(int g, int v0, int t) {
+    return (t > RR_JUMP_MAX_TICKS) ? RR_JUMP_HOVER
+         : (rrJumpY(g, v0, 0, t) >= 0) ? t
+         : rrJumpLanding(g, v0, t + 1);
+}
+
+constexpr int rrJumpRiseAt(int g, int v0, int landing, int t) {
+    return (landing != RR_JUMP_HOVER && t >= landing) ? 0 : -rrJumpY(g, v0, 0, t);
+}
+constexpr int rrJumpVelocityAt(int g, int v0, int landing, int t) {
+    return (landing != RR_JUMP_HOVER && t >= landing) ? 0 : rrJumpV(g, v0, t);
+}
+
+template<int... T>
+constexpr RRJumpTrack rrJumpTrackFrom(int g, int v0, int landing, RRSeq<T...>) {
+    return {g, v0, landing, {rrJumpRiseAt(g, v0, landing, T)...}, {rrJumpVelocityAt(g, v0, landing, T)...}};
+}
+
+constexpr RRJumpTrack rrMakeJumpTrack(int c, int level) {
+    return rrJumpTrackFrom(rrJumpGravity(c, level), rrJumpTakeoff(c),
+                           rrJumpLanding(rrJumpGravity(c, level), rrJumpTakeoff(c), 1),
+                           RRMakeSeq<RR_JUMP_MAX_TICKS + 1>::type());
+}
+
+// 一个角色在各重力等级下的轨迹
+#define RR_JUMP_TRACKS(c) \
+    {rrMakeJumpTrack(c, 1), rrMakeJumpTrack(c, 2), rrMakeJumpTrack(c, 3), \
+     rrMakeJumpTrack(c, 4), rrMakeJumpTrack(c, 5)}
+
+#endif
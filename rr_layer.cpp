@@ -0,0 +1,48 @@
+/*
+ * 文件名: rr_layer.cpp
+ * 描述: 静止背景的图层缓存
+ */
+#include <string.h>
+
+#include "rr_layer.h"
+
+void rrLayerCacheInit(RRLayerCache* c) {
+    memset(c, 0, sizeof(RRLayerCache));
+}
+
+void rrLayerCacheFree(RRLayerCache* c, RRRenderer* r) {
+    for (int i = 0; i < RR_LAYER_SLOTS; i++) {
+        if (c->slots[i].image != NULL) rrFreeLayer(r, c->slots[i].image);
+    }
+    memset(c, 0, sizeof(RRLayerCache));
+}
+
+void rrLayerDraw(RRLayerCache* c, RRRenderer* r, int slot, int theme, RRLayerPaint paint) {
+    if (c == NULL || slot < 0 || slot >= RR_LAYER_SLOTS) {
+        paint(r, theme, r->width, r->height);
+        return;
+    }
+
+    RRLayerSlot* s = &c->slots[slot];
+    if (s->image == NULL || s->theme != theme || s->width != r->width || s->height != r->height) {
+        if (s->image != NULL && (s->width != r->width || s->height != r->height)) {
+            rrFreeLayer(r, s->image);
+            s->image = NULL;
+        }
+        if (s->image == NULL) s->image = rrCreateLayer(r, r->width, r->height);
+        if (s->image == NULL) {
+            c->fallbacks++;
+            paint(r, theme, r->width, r->height);
+            return;
+        }
+        s->theme = theme;
+        s->width = r->width;
+        s->height = r->height;
+
+        rrBeginLayer(r, s->image);
+        paint(r, theme, s->width, s->height);
+        rrEndLayer(r);
+        c->builds++;
+    }
+    rrDrawLayer(r, s->image, 0, 0, s->width, s->height);
+}
@@ -0,0 +1,38 @@
+/*
+ * 文件名: rr_layer.h
+ * 描述: 静止背景的图层缓存: 每个背景 (菜单渐变、各画面的底色等) 占一个槽，
+ *       第一次用到时画进离屏图层，以后每帧整块贴上 (软件后端是逐行 memcpy，EasyX 是 putimage)
+ *       槽记下建图层时的主题 (GameConfig.themeColor) 和窗口尺寸，任何一个变了才重画
+ *       一个缓存只给一个后端用 (图层是那个后端的对象)
+ */
+#ifndef RR_LAYER_H
+#define RR_LAYER_H
+
+#include "rr_render.h"
+
+#define RR_LAYER_SLOTS 8
+
+// 把背景画到 r 上 (图层或屏幕)，尺寸是 width x height
+typedef void (*RRLayerPaint)(RRRenderer* r, int theme, int width, int height);
+
+typedef struct {
+    void* image;                // 后端的图层，NULL = 还没建
+    int theme;                  // 建图层时的主题和尺寸
+    int width, height;
+} RRLayerSlot;
+
+typedef struct {
+    RRLayerSlot slots[RR_LAYER_SLOTS];
+    int builds;                 // 统计: 画进图层的次数
+    int fallbacks;              // 统计: 后端建不了图层，直接画到屏幕的次数
+} RRLayerCache;
+
+void rrLayerCacheInit(RRLayerCache* c);
+// 释放全部图层 (r 必须是建图层的那个后端)
+void rrLayerCacheFree(RRLayerCache* c, RRRenderer* r);
+
+// 画出 slot 号背景: 缓存有效就贴图层，否则先用 paint 重画图层
+// c 为 NULL 时每次直接 paint (不用缓存)
+void rrLayerDraw(RRLayerCache* c, RRRenderer* r, int slot, int theme, RRLayerPaint paint);
+
+#endif
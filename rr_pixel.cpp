@@ -0,0 +1,179 @@
+/*
+ * 文件名: rr_pixel.cpp
+ * 描述: 像素内核
+ *       除以 255 并四舍五入: t' = t + 128, (t' + (t' >> 8)) >> 8，对 t <= 255 * 255 精确，
+ *       中间结果不超过 16 位，SIMD 版本在 16 位通道里算，和标量版本逐位相同
+ *       全透明 (整个像素为 0) 跳过、不透明直接写，两条捷径的结果和完整公式一样
+ */
+#include <string.h>
+
+#include "rr_cpu.h"
+#include "rr_pixel.h"
+
+typedef void (*BlendFn)(uint32_t* dst, const uint32_t* src, int first, int n);
+
+static inline uint32_t div255(uint32_t t) {
+    t += 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+// --- 标量版本 (也用来处理 SIMD 版本剩下的尾部) ---
+static void blendScalar(uint32_t* dst, const uint32_t* src, int first, int n) {
+    for (int i = first; i < n; i++) {
+        uint32_t s = src[i];
+        if (s == 0) continue;
+        uint32_t inv = 255 - (s >> 24);
+        if (inv == 0) {
+            dst[i] = s;
+            continue;
+        }
+        uint32_t d = dst[i], out = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            uint32_t c = ((s >> shift) & 0xFF) + div255(((d >> shift) & 0xFF) * inv);
+            if (c > 255) c = 255;
+            out |= c << shift;
+        }
+        dst[i] = out;
+    }
+}
+
+#ifdef RR_X86
+// --- SSE2: 每次 4 个 ---
+// 两个像素 (8 个 16 位通道) 乘 255 - alpha 再除以 255
+RR_TARGET("sse2")
+static inline __m128i scaleSse2(__m128i d16, __m128i inv16) {
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(d16, inv16), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+RR_TARGET("sse2")
+static void blendSse2(uint32_t* dst, const uint32_t* src, int first, int n) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i full = _mm_set1_epi32(255);
+    int i = first;
+    for (; i + 4 <= n; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(s, zero)) == 0xFFFF) continue;
+        __m128i inv = _mm_sub_epi32(full, _mm_srli_epi32(s, 24));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(inv, zero)) == 0xFFFF) {
+            _mm_storeu_si128((__m128i*)(dst + i), s);
+            continue;
+        }
+        inv = _mm_or_si128(inv, _mm_slli_epi32(inv, 16));       // 每个像素的两个 16 位半边都是 255 - a
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i lo = scaleSse2(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi32(inv, inv));
+        __m128i hi = scaleSse2(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi32(inv, inv));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_adds_epu8(s, _mm_packus_epi16(lo, hi)));
+    }
+    blendScalar(dst, src, i, n);
+}
+
+// --- AVX2: 每次 8 个 (unpack / pack 都在 128 位内，两边配对一致) ---
+RR_TARGET("avx2")
+static inline __m256i scaleAvx2(__m256i d16, __m256i inv16) {
+    __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(d16, inv16), _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+RR_TARGET("avx2")
+static void blendAvx2(uint32_t* dst, const uint32_t* src, int first, int n) {
+    __m256i zero = _mm256_setzero_si256();
+    __m256i full = _mm256_set1_epi32(255);
+    int i = first;
+    for (; i + 8 <= n; i += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(s, zero)) == -1) continue;
+        __m256i inv = _mm256_sub_epi32(full, _mm256_srli_epi32(s, 24));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(inv, zero)) == -1) {
+            _mm256_storeu_si256((__m256i*)(dst + i), s);
+            continue;
+        }
+        inv = _mm256_or_si256(inv, _mm256_slli_epi32(inv, 16));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i lo = scaleAvx2(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi32(inv, inv));
+        __m256i hi = scaleAvx2(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi32(inv, inv));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_adds_epu8(s, _mm256_packus_epi16(lo, hi)));
+    }
+    blendScalar(dst, src, i, n);
+}
+#endif
+
+// --- 实现选择 ---
+typedef struct {
+    int level;
+    BlendFn blend;
+} Kernels;
+
+static Kernels selectKernels(int level) {
+    int supported = rrCpuSimdLevel();
+    if (level > supported) level = supported;
+
+    Kernels k = {RR_SIMD_SCALAR, blendScalar};
+#ifdef RR_X86
+    if (level >= RR_SIMD_AVX2) {
+        k.level = RR_SIMD_AVX2;
+        k.blend = blendAvx2;
+    } else if (level >= RR_SIMD_SSE2) {
+        k.level = RR_SIMD_SSE2;
+        k.blend = blendSse2;
+    }
+#endif
+    return k;
+}
+
+// 程序启动时按 CPU 选好，之后只读 (多线程光栅化可以直接用)
+static Kernels kernels = selectKernels(RR_SIMD_COUNT);
+
+// 填充只是连续写同一个值，交给编译器向量化的普通循环最快 (rr_pixel_bench)，不分级别
+// 按 8 个一组写: 长度不定的循环 g++ -O2 不向量化，固定 8 次的内层会合成向量写
+void rrFillSpan(uint32_t* dst, int n, uint32_t color) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (int k = 0; k < 8; k++) dst[i + k] = color;
+    }
+    for (; i < n; i++) dst[i] = color;
+}
+
+void rrBlendSpan(uint32_t* dst, const uint32_t* src, int n) {
+    kernels.blend(dst, src, 0, n);
+}
+
+void rrBlitAlpha(uint32_t* dst, int dstStride, const uint32_t* src, int srcStride, int width, int height) {
+    for (int y = 0; y < height; y++) {
+        kernels.blend(dst + (size_t)y * dstStride, src + (size_t)y * srcStride, 0, width);
+    }
+}
+
+void rrGradientFill(uint32_t* dst, int stride, int width, int height, uint32_t top, uint32_t bottom) {
+    int r0 = (top >> 16) & 0xFF, g0 = (top >> 8) & 0xFF, b0 = top & 0xFF;
+    int dr = (int)((bottom >> 16) & 0xFF) - r0;
+    int dg = (int)((bottom >> 8) & 0xFF) - g0;
+    int db = (int)(bottom & 0xFF) - b0;
+    for (int i = 0; i < height; i++) {
+        uint32_t color = ((uint32_t)(r0 + i * dr / height) << 16) | ((uint32_t)(g0 + i * dg / height) << 8) |
+                         (uint32_t)(b0 + i * db / height);
+        rrFillSpan(dst + (size_t)i * stride, width, color);
+    }
+}
+
+void rrPremultiply(uint32_t* pixels, int n) {
+    for (int i = 0; i < n; i++) {
+        uint32_t p = pixels[i], a = p >> 24;
+        if (a == 255) continue;
+        if (a == 0) {
+            pixels[i] = 0;
+            continue;
+        }
+        uint32_t r = div255(((p >> 16) & 0xFF) * a), g = div255(((p >> 8) & 0xFF) * a), b = div255((p & 0xFF) * a);
+        pixels[i] = (a << 24) | (r << 16) | (g << 8) | b;
+    }
+}
+
+int rrPixelLevel() {
+    return kernels.level;
+}
+
+int rrPixelSetLevel(int level) {
+    kernels = selectKernels(level);
+    return kernels.level;
+}
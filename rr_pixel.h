@@ -0,0 +1,32 @@
+/*
+ * 文件名: rr_pixel.h
+ * 描述: 像素内核: 纯色 span 填充、预乘 alpha 贴图、竖直渐变填充
+ *       贴图 (混合) 有标量 / SSE2 / AVX2 三种实现，运行时选择；填充和渐变是普通循环，交给编译器向量化
+ *       像素格式 0xAARRGGBB (内存里 B G R A)，和 EasyX 的 GetImageBuffer、rr_render_soft 的帧缓冲相同
+ *       混合: out = src + dst * (255 - srcA) / 255，每个通道四舍五入，各实现结果逐位一致
+ */
+#ifndef RR_PIXEL_H
+#define RR_PIXEL_H
+
+#include <stdint.h>
+
+// dst[0 .. n) 填成 color
+void rrFillSpan(uint32_t* dst, int n, uint32_t color);
+
+// 预乘 alpha 的 src[0 .. n) 叠到 dst 上 (src over dst)
+void rrBlendSpan(uint32_t* dst, const uint32_t* src, int n);
+
+// 逐行 rrBlendSpan，stride 以像素计
+void rrBlitAlpha(uint32_t* dst, int dstStride, const uint32_t* src, int srcStride, int width, int height);
+
+// 竖直渐变: 第 i 行每个通道 = top + (bottom - top) * i / height (整数除法，与 rr_draw 的菜单背景相同)
+void rrGradientFill(uint32_t* dst, int stride, int width, int height, uint32_t top, uint32_t bottom);
+
+// 普通 alpha (loadimage(..., true) 读出来的 PNG) 转成预乘 alpha，载入时做一次
+void rrPremultiply(uint32_t* pixels, int n);
+
+// --- 实现选择 ---
+int rrPixelLevel();                     // 混合当前使用的 RRSimdLevel
+int rrPixelSetLevel(int level);         // 强制指定 (超过 CPU 支持时取支持的最高级)，返回实际级别；非线程安全
+
+#endif
@@ -0,0 +1,68 @@
+/*
+ * 文件名: rr_random.h
+ * 描述: 可复现的随机数流 (xoshiro128**)，代替全局 rand()
+ *       每个子系统 (障碍物生成 / 云朵 / 画面效果) 各用一条独立的流，
+ *       都由同一个局种子派生，互不干扰，也没有 libc rand() 的锁
+ */
+#ifndef RR_RANDOM_H
+#define RR_RANDOM_H
+
+#include <stdint.h>
+
+// --- 随机数流编号 ---
+typedef enum {
+    RR_STREAM_SPAWN = 1,    // 障碍物生成 (影响玩法)
+    RR_STREAM_CLOUDS = 2,   // 云朵 (影响画面，不影响玩法)
+    RR_STREAM_VISUAL = 3,   // 纯渲染效果 (星空等)
+    RR_STREAM_POLICY = 4    // 平衡性模拟里脚本玩家的反应误差 (rr_balance)
+} RRStreamId;
+
+typedef struct {
+    uint32_t s[4];
+} RRRng;
+
+// splitmix64: 把种子展开成均匀的状态
+static inline uint64_t rrSplitMix64(uint64_t* x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// 由局种子和流编号得到一条独立的流
+static inline void rrRngSeed(RRRng* r, uint64_t seed, uint32_t stream) {
+    uint64_t x = seed ^ ((uint64_t)stream * 0xD1B54A32D192ED03ull);
+    uint64_t a = rrSplitMix64(&x);
+    uint64_t b = rrSplitMix64(&x);
+    r->s[0] = (uint32_t)a;
+    r->s[1] = (uint32_t)(a >> 32);
+    r->s[2] = (uint32_t)b;
+    r->s[3] = (uint32_t)(b >> 32);
+    if ((r->s[0] | r->s[1] | r->s[2] | r->s[3]) == 0) r->s[0] = 1; // 全零状态不可用
+}
+
+static inline uint32_t rrRotl(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+// xoshiro128**: 下一个 32 位随机数
+static inline uint32_t rrRngNext(RRRng* r) {
+    uint32_t* s = r->s;
+    uint32_t result = rrRotl(s[1] * 5, 7) * 9;
+    uint32_t t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rrRotl(s[3], 11);
+    return result;
+}
+
+// [0, n) 内的整数 (乘法取高位，代替 rand() % n)
+static inline int rrRngRange(RRRng* r, int n) {
+    return (int)(((uint64_t)rrRngNext(r) * (uint32_t)n) >> 32);
+}
+
+#endif
@@ -0,0 +1,178 @@
+/*
+ * 文件名: rr_render.h
+ * 描述: 绘制后端接口 (只包含游戏实际用到的图元)
+ *       画面代码 (rr_draw) 只调这里的函数，不直接碰 EasyX:
+ *       Windows 上用 EasyX 实现 (rr_render_easyx)，无界面时用纯 CPU 的 BGRA 帧缓冲 (rr_render_soft)，
+ *       在 Linux 上也能跑完整的绘制路径做性能分析
+ *       当前颜色 / 字号跟 EasyX 一样是状态，存在 RRRenderer 里，后端每次调用拿到的是具体颜色
+ *       坐标规则与 EasyX 相同: 矩形和椭圆的外接框包含两端点
+ *       图层是后端的离屏图像 (EasyX 的 IMAGE)，静止的背景画进去一次，以后每帧整块贴上 (见 rr_layer)
+ */
+#ifndef RR_RENDER_H
+#define RR_RENDER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// --- 颜色: 0x00RRGGBB (小端内存顺序 B G R A，与帧缓冲一致) ---
+typedef uint32_t RRColor;
+
+#define RR_RGB(r, g, b) ((RRColor)((((r) & 0xFF) << 16) | (((g) & 0xFF) << 8) | ((b) & 0xFF)))
+#define RR_RED(c) (((c) >> 16) & 0xFF)
+#define RR_GREEN(c) (((c) >> 8) & 0xFF)
+#define RR_BLUE(c) ((c) & 0xFF)
+
+typedef struct {
+    int x, y;
+} RRPoint;
+
+typedef struct {
+    int left, top, right, bottom;   // 含两端
+} RRRect;
+
+static inline int rrRectEmpty(RRRect r) {
+    return r.left > r.right || r.top > r.bottom;
+}
+static inline RRRect rrRectMake(int x1, int y1, int x2, int y2) {
+    RRRect r;
+    r.left = (x1 < x2) ? x1 : x2;
+    r.right = (x1 < x2) ? x2 : x1;
+    r.top = (y1 < y2) ? y1 : y2;
+    r.bottom = (y1 < y2) ? y2 : y1;
+    return r;
+}
+static inline RRRect rrRectIntersect(RRRect a, RRRect b) {
+    RRRect r;
+    r.left = (a.left > b.left) ? a.left : b.left;
+    r.top = (a.top > b.top) ? a.top : b.top;
+    r.right = (a.right < b.right) ? a.right : b.right;
+    r.bottom = (a.bottom < b.bottom) ? a.bottom : b.bottom;
+    return r;
+}
+static inline RRRect rrRectUnion(RRRect a, RRRect b) {
+    RRRect r;
+    r.left = (a.left < b.left) ? a.left : b.left;
+    r.top = (a.top < b.top) ? a.top : b.top;
+    r.right = (a.right > b.right) ? a.right : b.right;
+    r.bottom = (a.bottom > b.bottom) ? a.bottom : b.bottom;
+    return r;
+}
+static inline int rrRectOverlap(RRRect a, RRRect b) {
+    return a.left <= b.right && b.left <= a.right && a.top <= b.bottom && b.top <= a.bottom;
+}
+
+// --- 后端实现的图元 (impl 是后端自己的状态) ---
+typedef struct {
+    void (*clear)(void* impl, RRColor color);
+    void (*solidRect)(void* impl, int left, int top, int right, int bottom, RRColor color);
+    void (*rect)(void* impl, int left, int top, int right, int bottom, RRColor color);        // 1 像素边框
+    void (*solidEllipse)(void* impl, int left, int top, int right, int bottom, RRColor color);
+    void (*ellipse)(void* impl, int left, int top, int right, int bottom, RRColor color);     // 1 像素边框
+    void (*solidCircle)(void* impl, int x, int y, int radius, RRColor color);
+    void (*solidPolygon)(void* impl, const RRPoint* points, int count, RRColor color);
+    void (*line)(void* impl, int x1, int y1, int x2, int y2, RRColor color);
+    void (*text)(void* impl, int x, int y, const char* text, int height, RRColor color);
+    int (*textWidth)(void* impl, const char* text, int height);
+    void (*setClip)(void* impl, int left, int top, int right, int bottom);                   // 之后的图元只画在这个框里 (含两端)
+    void* (*createLayer)(void* impl, int width, int height);                                 // 离屏图层，失败返回 NULL
+    void (*freeLayer)(void* impl, void* layer);
+    void (*beginLayer)(void* impl, void* layer);                                             // 之后的图元画进 layer，NULL = 回到屏幕 (裁剪框恢复整屏)
+    void (*drawLayer)(void* impl, void* layer, int x, int y, int width, int height);         // 图层左上角 width x height 贴到 (x, y)
+    void (*present)(void* impl);                                                             // 一帧画完
+} RRRenderOps;
+
+typedef struct {
+    const RRRenderOps* ops;
+    void* impl;
+    int width, height;
+
+    // 当前绘制状态 (对应 setfillcolor / setlinecolor / settextcolor / settextstyle)
+    RRColor fillColor;
+    RRColor lineColor;
+    RRColor textColor;
+    int textHeight;
+} RRRenderer;
+
+// 后端初始化时调用，状态取 EasyX 的默认值
+static inline void rrRendererInit(RRRenderer* r, const RRRenderOps* ops, void* impl, int width, int height) {
+    r->ops = ops;
+    r->impl = impl;
+    r->width = width;
+    r->height = height;
+    r->fillColor = RR_RGB(255, 255, 255);
+    r->lineColor = RR_RGB(255, 255, 255);
+    r->textColor = RR_RGB(255, 255, 255);
+    r->textHeight = 16;
+}
+
+// --- 状态 ---
+static inline void rrSetFillColor(RRRenderer* r, RRColor c) { r->fillColor = c; }
+static inline void rrSetLineColor(RRRenderer* r, RRColor c) { r->lineColor = c; }
+static inline void rrSetTextColor(RRRenderer* r, RRColor c) { r->textColor = c; }
+static inline void rrSetTextHeight(RRRenderer* r, int height) { r->textHeight = height; }
+
+// --- 图元 (名字对应 EasyX: fill = 填充 + 边框，solid = 只填充) ---
+static inline void rrClear(RRRenderer* r) {
+    r->ops->clear(r->impl, RR_RGB(0, 0, 0));
+}
+static inline void rrSolidRect(RRRenderer* r, int left, int top, int right, int bottom) {
+    r->ops->solidRect(r->impl, left, top, right, bottom, r->fillColor);
+}
+static inline void rrRect(RRRenderer* r, int left, int top, int right, int bottom) {
+    r->ops->rect(r->impl, left, top, right, bottom, r->lineColor);
+}
+static inline void rrFillRect(RRRenderer* r, int left, int top, int right, int bottom) {
+    r->ops->solidRect(r->impl, left, top, right, bottom, r->fillColor);
+    r->ops->rect(r->impl, left, top, right, bottom, r->lineColor);
+}
+static inline void rrFillEllipse(RRRenderer* r, int left, int top, int right, int bottom) {
+    r->ops->solidEllipse(r->impl, left, top, right, bottom, r->fillColor);
+    r->ops->ellipse(r->impl, left, top, right, bottom, r->lineColor);
+}
+static inline void rrSolidCircle(RRRenderer* r, int x, int y, int radius) {
+    r->ops->solidCircle(r->impl, x, y, radius, r->fillColor);
+}
+static inline void rrSolidPolygon(RRRenderer* r, const RRPoint* points, int count) {
+    r->ops->solidPolygon(r->impl, points, count, r->fillColor);
+}
+static inline void rrLine(RRRenderer* r, int x1, int y1, int x2, int y2) {
+    r->ops->line(r->impl, x1, y1, x2, y2, r->lineColor);
+}
+static inline void rrText(RRRenderer* r, int x, int y, const char* text) {
+    r->ops->text(r->impl, x, y, text, r->textHeight, r->textColor);
+}
+static inline int rrTextWidth(RRRenderer* r, const char* text) {
+    return r->ops->textWidth(r->impl, text, r->textHeight);
+}
+static inline int rrTextHeight(RRRenderer* r) {
+    return r->textHeight;
+}
+static inline void rrSetClip(RRRenderer* r, int left, int top, int right, int bottom) {
+    r->ops->setClip(r->impl, left, top, right, bottom);
+}
+static inline void rrResetClip(RRRenderer* r) {
+    r->ops->setClip(r->impl, 0, 0, r->width - 1, r->height - 1);
+}
+
+// --- 图层 ---
+static inline void* rrCreateLayer(RRRenderer* r, int width, int height) {
+    return r->ops->createLayer(r->impl, width, height);
+}
+static inline void rrFreeLayer(RRRenderer* r, void* layer) {
+    r->ops->freeLayer(r->impl, layer);
+}
+static inline void rrBeginLayer(RRRenderer* r, void* layer) {
+    r->ops->beginLayer(r->impl, layer);
+}
+static inline void rrEndLayer(RRRenderer* r) {
+    r->ops->beginLayer(r->impl, NULL);
+}
+static inline void rrDrawLayer(RRRenderer* r, void* layer, int x, int y, int width, int height) {
+    r->ops->drawLayer(r->impl, layer, x, y, width, height);
+}
+
+static inline void rrPresent(RRRenderer* r) {
+    r->ops->present(r->impl);
+}
+
+#endif
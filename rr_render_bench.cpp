@@ -0,0 +1,216 @@
+/*
+ * 文件名: rr_render_bench.cpp
+ * 描述: 无界面绘制基准: 用纯 CPU 后端把每个画面画若干帧，报告每帧耗时和填充量
+ *       游戏画面由自动驾驶推进 (每帧一步，按半步插值)，三个难度的主题各测一遍
+ *       每帧画两遍: 直接画整屏，以及经过脏矩形合成器 (rr_compose) 只重画变化的部分，
+ *       逐帧比较两块帧缓冲，必须完全相同
+ *       第三遍经过命令缓冲 (rr_batch) 按状态分批后整屏画，同样必须和直接画的一致，并报告状态切换次数
+ *       静止背景走图层缓存 (rr_layer)、HUD 文字走文字缓存 (rr_hud)，每个后端一份；
+ *       加 nolayers 参数则每帧直接画背景和文字，用来对比
+ *       给出输出目录时把每个画面的最后一帧存成 BMP，方便对照；
+ *       最后一帧分批提交的命令同时转储成 <画面>.cmds，再重放到一块新的帧缓冲上核对
+ * 编译: g++ -O2 -std=c++11 rr_render_bench.cpp rr_draw.cpp rr_layer.cpp rr_hud.cpp rr_compose.cpp rr_batch.cpp rr_arena.cpp rr_render_soft.cpp rr_pixel.cpp rr_bot.cpp rr_core.cpp rr_collide.cpp -o rr_render_bench
+ * 用法: rr_render_bench [每个画面帧数=600] [BMP输出目录] [种子=1] [nolayers]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include "rr_batch.h"
+#include "rr_bot.h"
+#include "rr_compose.h"
+#include "rr_draw.h"
+#include "rr_render_soft.h"
+
+// --- 被测画面 ---
+typedef struct {
+    const char* name;
+    GameState state;
+    DifficultyLevel level;      // 游戏画面的难度 (决定主题)
+} BenchScene;
+
+const BenchScene benchScenes[] = {
+    {"menu", STATE_MENU, LEVEL_NORMAL},
+    {"char_select", STATE_CHAR_SELECT, LEVEL_NORMAL},
+    {"level_select", STATE_LEVEL_SELECT, LEVEL_NORMAL},
+    {"game_easy", STATE_GAME, LEVEL_EASY},
+    {"game_normal", STATE_GAME, LEVEL_NORMAL},
+    {"game_hard", STATE_GAME, LEVEL_HARD},
+    {"game_over", STATE_GAME_OVER, LEVEL_NORMAL}
+};
+
+#define BENCH_SCENE_COUNT ((int)(sizeof(benchScenes) / sizeof(benchScenes[0])))
+
+int main(int argc, char** argv) {
+    int frames = (argc > 1) ? atoi(argv[1]) : 600;
+    const char* outDir = (argc > 2) ? argv[2] : NULL;
+    unsigned long long seed = (argc > 3) ? strtoull(argv[3], NULL, 10) : 1;
+    int useLayers = !(argc > 4 && strcmp(argv[4], "nolayers") == 0);
+    if (frames <= 0) {
+        printf("用法: rr_render_bench [每个画面帧数] [BMP输出目录] [种子] [nolayers]\n");
+        return 1;
+    }
+
+    RRRenderer renderer, composedTarget, composed, batchedTarget, batched;
+    RRSoftTarget target, composedPixels, batchedPixels;
+    RRCompositor compositor;
+    RRBatcher batcher;
+    if (!rrSoftInit(&renderer, &target, WIN_WIDTH, WIN_HEIGHT) ||
+        !rrSoftInit(&composedTarget, &composedPixels, WIN_WIDTH, WIN_HEIGHT) ||
+        !rrSoftInit(&batchedTarget, &batchedPixels, WIN_WIDTH, WIN_HEIGHT)) {
+        printf("帧缓冲分配失败\n");
+        return 1;
+    }
+    rrCompositorInit(&composed, &compositor, &composedTarget);
+    rrBatchInit(&batched, &batcher, &batchedTarget);
+    RRLayerCache layers, composedLayers, batchedLayers;
+    rrLayerCacheInit(&layers);
+    rrLayerCacheInit(&composedLayers);
+    rrLayerCacheInit(&batchedLayers);
+    RRHud hud, composedHud, batchedHud;
+    rrHudInit(&hud);
+    rrHudInit(&composedHud);
+    rrHudInit(&batchedHud);
+
+    static RRScene scene;
+    static RRWorld world, prevWorld;
+    memset(&scene, 0, sizeof(scene));
+    scene.selectedChar = CHAR_DEFAULT;
+    scene.highScore = 12345;
+
+    printf("%dx%d, 每个画面 %d 帧, 背景%s\n", WIN_WIDTH, WIN_HEIGHT, frames, useLayers ? "图层缓存" : "每帧直接画");
+    printf("%-14s | %-27s | %-35s\n", "", "整屏重画", "脏矩形合成");
+    printf("%-14s | %8s %8s %9s | %8s %8s %9s %6s | %s\n", "画面", "微秒/帧", "最慢", "像素/帧",
+           "微秒/帧", "最慢", "像素/帧", "脏矩形", "结果");
+    int allSame = 1;
+
+    for (int k = 0; k < BENCH_SCENE_COUNT; k++) {
+        const BenchScene* b = &benchScenes[k];
+        RRBot bot;
+        RRInput input;
+
+        scene.state = b->state;
+        scene.selectedLevel = b->level;
+        scene.nightMode = (levelConfigs[b->level].themeColor == 2);
+        scene.autoplay = 1;
+        scene.newRecord = (b->state == STATE_GAME_OVER);
+        rrInitWorld(&world, scene.selectedChar, b->level, seed);
+        rrBotInit(&bot);
+        prevWorld = world;
+
+        double total = 0, worst = 0, composedTotal = 0, composedWorst = 0;
+        long long pixels0 = target.pixelsWritten, composedPixels0 = composedPixels.pixelsWritten;
+        long long damageRects = 0;
+        double batchedTotal = 0;
+        long long cmds = 0, batches = 0, merged = 0, changesBefore = 0, changesAfter = 0;
+        int same = 1, batchedSame = 1;
+        char dumpPath[512] = "";
+        for (int f = 0; f < frames; f++) {
+            // 只有游戏画面的世界在推进 (与 new.cpp 相同)
+            if (b->state == STATE_GAME && !world.gameOver) {
+                prevWorld = world;
+                rrBotInput(&bot, &world, &input);
+                rrStep(&world, &input);
+            }
+
+            rrSceneInterpolate(&scene, &prevWorld, &world, (b->state == STATE_GAME) ? 0.5 : 1.0);
+
+            std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+            scene.layers = useLayers ? &layers : NULL;
+            scene.hud = useLayers ? &hud : NULL;
+            rrDrawScene(&renderer, &scene);
+            rrPresent(&renderer);
+            std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+            scene.layers = useLayers ? &composedLayers : NULL;
+            scene.hud = useLayers ? &composedHud : NULL;
+            rrDrawScene(&composed, &scene);
+            rrPresent(&composed);
+            std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+            // 转储的那一帧不走图层: 转储里没有图层的像素，重放时得把背景也画出来
+            int dumping = (outDir != NULL && f == frames - 1);
+            if (dumping) {
+                snprintf(dumpPath, sizeof(dumpPath), "%s/%s.cmds", outDir, b->name);
+                batcher.dump = fopen(dumpPath, "w");
+                if (batcher.dump == NULL) dumpPath[0] = 0;
+            }
+            scene.layers = (useLayers && !dumping) ? &batchedLayers : NULL;
+            scene.hud = (useLayers && !dumping) ? &batchedHud : NULL;
+            std::chrono::steady_clock::time_point t3 = std::chrono::steady_clock::now();
+            rrDrawScene(&batched, &scene);
+            rrPresent(&batched);
+            std::chrono::steady_clock::time_point t4 = std::chrono::steady_clock::now();
+            batchedTotal += std::chrono::duration<double, std::micro>(t4 - t3).count();
+            cmds += batcher.lastCmds;
+            batches += batcher.lastBatches;
+            merged += batcher.lastMerged;
+            changesBefore += batcher.lastChangesBefore;
+            changesAfter += batcher.lastChangesAfter;
+            if (memcmp(target.pixels, batchedPixels.pixels, sizeof(uint32_t) * WIN_WIDTH * WIN_HEIGHT) != 0) {
+                batchedSame = 0;
+            }
+
+            double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+            double composedUs = std::chrono::duration<double, std::micro>(t2 - t1).count();
+            total += us;
+            composedTotal += composedUs;
+            if (us > worst) worst = us;
+            if (composedUs > composedWorst) composedWorst = composedUs;
+            damageRects += compositor.lastDamageRects;
+            if (memcmp(target.pixels, composedPixels.pixels, sizeof(uint32_t) * WIN_WIDTH * WIN_HEIGHT) != 0) same = 0;
+        }
+        rrBotFree(&bot);
+
+        double pixels = (double)(target.pixelsWritten - pixels0) / frames;
+        double composedPx = (double)(composedPixels.pixelsWritten - composedPixels0) / frames;
+        printf("%-14s | %8.1f %8.1f %9.0f | %8.1f %8.1f %9.0f %6.1f | %s\n", b->name,
+               total / frames, worst, pixels, composedTotal / frames, composedWorst, composedPx,
+               (double)damageRects / frames, same ? "一致" : "不一致!");
+        printf("%-14s   分批: %8.1f 微秒/帧, 命令 %.0f -> %.0f 批 (合并矩形 %.1f), 状态切换 %.1f -> %.1f | %s\n", "",
+               batchedTotal / frames, (double)cmds / frames, (double)batches / frames, (double)merged / frames,
+               (double)changesBefore / frames, (double)changesAfter / frames, batchedSame ? "一致" : "不一致!");
+        allSame &= same & batchedSame;
+
+        if (dumpPath[0]) {
+            // 转储重放到一块新的帧缓冲上，应当和最后一帧一模一样
+            RRRenderer replay;
+            RRSoftTarget replayPixels;
+            FILE* in = fopen(dumpPath, "r");
+            int replayed = -1, replaySame = 0;
+            if (in != NULL && rrSoftInit(&replay, &replayPixels, WIN_WIDTH, WIN_HEIGHT)) {
+                replayed = rrBatchReplayDump(in, &replay);
+                replaySame = (replayed >= 0 &&
+                              memcmp(target.pixels, replayPixels.pixels, sizeof(uint32_t) * WIN_WIDTH * WIN_HEIGHT) == 0);
+                rrSoftFree(&replayPixels);
+            }
+            if (in != NULL) fclose(in);
+            printf("%-14s   重放 %s: %d 条命令 | %s\n", "", dumpPath, replayed, replaySame ? "一致" : "不一致!");
+            allSame &= replaySame;
+        }
+
+        if (outDir) {
+            char path[512];
+            snprintf(path, sizeof(path), "%s/%s.bmp", outDir, b->name);
+            if (!rrSoftSaveBMP(&target, path)) printf("  无法写入 %s\n", path);
+        }
+    }
+
+    if (useLayers) {
+        printf("图层重画次数: 整屏 %d, 合成 %d\n", layers.builds, composedLayers.builds);
+        printf("HUD 文字: 重画 %d 次, 贴缓存 %d 次\n", hud.renders, hud.hits);
+    }
+
+    rrLayerCacheFree(&layers, &renderer);
+    rrLayerCacheFree(&composedLayers, &composed);
+    rrLayerCacheFree(&batchedLayers, &batched);
+    rrHudFree(&hud, &renderer);
+    rrHudFree(&composedHud, &composed);
+    rrHudFree(&batchedHud, &batched);
+    rrCompositorFree(&compositor);
+    rrBatchFree(&batcher);
+    rrSoftFree(&batchedPixels);
+    rrSoftFree(&composedPixels);
+    rrSoftFree(&target);
+    return allSame ? 0 : 2;
+}
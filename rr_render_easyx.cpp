@@ -0,0 +1,157 @@
+/*
+ * 文件名: rr_render_easyx.cpp
+ * 描述: 绘制后端的 EasyX 实现，每个图元直接对应一个 EasyX 调用
+ *       EasyX 的颜色和字体是全局状态，这里记下上次设置的值，相同就不再设置
+ */
+#include <graphics.h>
+
+#include "rr_render_easyx.h"
+
+#define RR_FONT_NAME _T("Consolas")
+
+typedef struct {
+    RRColor lineColor;
+    RRColor fillColor;
+    RRColor textColor;
+    int textHeight;
+} EasyXState;
+
+static EasyXState easyx;
+
+static COLORREF toColorRef(RRColor c) {
+    return RGB(RR_RED(c), RR_GREEN(c), RR_BLUE(c));
+}
+
+static void useLine(RRColor c) {
+    if (c != easyx.lineColor) {
+        easyx.lineColor = c;
+        setlinecolor(toColorRef(c));
+    }
+}
+
+static void useFill(RRColor c) {
+    if (c != easyx.fillColor) {
+        easyx.fillColor = c;
+        setfillcolor(toColorRef(c));
+    }
+}
+
+static void useFont(int height) {
+    if (height != easyx.textHeight) {
+        easyx.textHeight = height;
+        settextstyle(height, 0, RR_FONT_NAME);
+    }
+}
+
+static void easyxClear(void*, RRColor color) {
+    setbkcolor(toColorRef(color));
+    cleardevice();
+    setbkcolor(BLACK);      // 文字背景 (默认 OPAQUE 模式) 保持黑色
+}
+
+static void easyxSolidRect(void*, int left, int top, int right, int bottom, RRColor color) {
+    useFill(color);
+    solidrectangle(left, top, right, bottom);
+}
+
+static void easyxRect(void*, int left, int top, int right, int bottom, RRColor color) {
+    useLine(color);
+    rectangle(left, top, right, bottom);
+}
+
+static void easyxSolidEllipse(void*, int left, int top, int right, int bottom, RRColor color) {
+    useFill(color);
+    solidellipse(left, top, right, bottom);
+}
+
+static void easyxEllipse(void*, int left, int top, int right, int bottom, RRColor color) {
+    useLine(color);
+    ellipse(left, top, right, bottom);
+}
+
+static void easyxSolidCircle(void*, int x, int y, int radius, RRColor color) {
+    useFill(color);
+    solidcircle(x, y, radius);
+}
+
+static void easyxSolidPolygon(void*, const RRPoint* points, int count, RRColor color) {
+    useFill(color);
+    solidpolygon((const POINT*)points, count);      // RRPoint 与 POINT 布局相同 (两个 int/LONG)
+}
+
+static void easyxLine(void*, int x1, int y1, int x2, int y2, RRColor color) {
+    useLine(color);
+    line(x1, y1, x2, y2);
+}
+
+static void easyxText(void*, int x, int y, const char* text, int height, RRColor color) {
+    useFont(height);
+    if (color != easyx.textColor) {
+        easyx.textColor = color;
+        settextcolor(toColorRef(color));
+    }
+    outtextxy(x, y, text);
+}
+
+static int easyxTextWidth(void*, const char* text, int height) {
+    useFont(height);
+    return textwidth(text);
+}
+
+static void easyxSetClip(void*, int left, int top, int right, int bottom) {
+    HRGN region = CreateRectRgn(left, top, right + 1, bottom + 1);
+    setcliprgn(region);
+    DeleteObject(region);       // setcliprgn 会复制一份
+}
+
+// --- 图层: EasyX 的 IMAGE，画的时候 SetWorkingImage 过去 ---
+static void* easyxCreateLayer(void*, int width, int height) {
+    return new IMAGE(width, height);
+}
+
+static void easyxFreeLayer(void*, void* layer) {
+    delete (IMAGE*)layer;
+}
+
+static void easyxBeginLayer(void*, void* layer) {
+    SetWorkingImage((IMAGE*)layer);
+    // 颜色和字体跟着绘图设备走，换了设备就全部重新设置
+    easyx.lineColor = easyx.fillColor = easyx.textColor = 0xFFFFFFFFu;
+    easyx.textHeight = -1;
+    setbkcolor(BLACK);
+    setcliprgn(NULL);
+}
+
+static void easyxDrawLayer(void*, void* layer, int x, int y, int width, int height) {
+    putimage(x, y, width, height, (IMAGE*)layer, 0, 0);
+}
+
+static void easyxPresent(void*) {
+    FlushBatchDraw();
+}
+
+static const RRRenderOps easyxOps = {
+    easyxClear,
+    easyxSolidRect,
+    easyxRect,
+    easyxSolidEllipse,
+    easyxEllipse,
+    easyxSolidCircle,
+    easyxSolidPolygon,
+    easyxLine,
+    easyxText,
+    easyxTextWidth,
+    easyxSetClip,
+    easyxCreateLayer,
+    easyxFreeLayer,
+    easyxBeginLayer,
+    easyxDrawLayer,
+    easyxPresent
+};
+
+void rrEasyXInit(RRRenderer* r, int width, int height) {
+    // 记成不可能的值，第一次用到时一定会设置
+    easyx.lineColor = easyx.fillColor = easyx.textColor = 0xFFFFFFFFu;
+    easyx.textHeight = -1;
+    rrRendererInit(r, &easyxOps, &easyx, width, height);
+}
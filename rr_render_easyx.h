@@ -0,0 +1,14 @@
+/*
+ * 文件名: rr_render_easyx.h
+ * 描述: 绘制后端的 EasyX 实现 (Windows)，画到 initgraph 打开的窗口，present = FlushBatchDraw
+ *       窗口的创建和 BeginBatchDraw / closegraph 仍由 new.cpp 负责
+ *       EasyX 的状态是全局的，不能多线程调用: new.cpp 把它的所有调用 (包括 initgraph、peekmessage) 放在渲染线程
+ */
+#ifndef RR_RENDER_EASYX_H
+#define RR_RENDER_EASYX_H
+
+#include "rr_render.h"
+
+void rrEasyXInit(RRRenderer* r, int width, int height);
+
+#endif
@@ -0,0 +1,434 @@
+/*
+ * 文件名: rr_render_soft.cpp
+ * 描述: 绘制后端的纯 CPU 实现
+ *       所有图元都拆成水平线段 (span) 写入帧缓冲，裁剪只在 span 一处做，
+ *       所以裁剪框内的像素与不裁剪时完全相同 (合成器按脏矩形重画依赖这一点)
+ *       span 的填充用 rr_pixel 的 rrFillSpan (普通循环，交给编译器向量化)
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rr_pixel.h"
+#include "rr_render_soft.h"
+
+#define GLYPH_ROWS 7            // 占位字形的格子: 7 行，半角 5 列 / 全角 10 列
+#define GLYPH_COLS 5
+
+// --- 基本写入 ---
+// 第 y 行 [x0, x1] (含两端)
+static void span(RRSoftTarget* t, int y, int x0, int x1, RRColor color) {
+    if (y < t->clipTop || y > t->clipBottom) return;
+    if (x0 < t->clipLeft) x0 = t->clipLeft;
+    if (x1 > t->clipRight) x1 = t->clipRight;
+    if (x0 > x1) return;
+
+    int n = x1 - x0 + 1;
+    rrFillSpan(t->pixels + (size_t)y * t->stride + x0, n, color);
+    t->pixelsWritten += n;
+}
+
+static void pixel(RRSoftTarget* t, int x, int y, RRColor color) {
+    span(t, y, x, x, color);
+}
+
+static void order(int* a, int* b) {
+    if (*a > *b) {
+        int tmp = *a;
+        *a = *b;
+        *b = tmp;
+    }
+}
+
+// --- 图元 ---
+static void softClear(void* impl, RRColor color) {
+    RRSoftTarget* t = (RRSoftTarget*)impl;
+    for (int y = t->clipTop; y <= t->clipBottom; y++) span(t, y, t->clipLeft, t->clipRight, color);
+}
+
+static void softSolidRect(void* impl, int left, int top, int right, int bottom, RRColor color) {
+    RRSoftTarget* t = (RRSoftTarget*)impl;
+    order(&left, &right);
+    order(&top, &bottom);
+    if (top < t->clipTop) top = t->clipTop;
+    if (bottom > t->clipBottom) bottom = t->clipBottom;
+    for (int y = top; y <= bottom; y++) span(t, y, left, right, color);
+}
+
+static void softRect(void* impl, int left, int top, int right, int bottom, RRColor color) {
+    RRSoftTarget* t = (RRSoftTarget*)impl;
+    order(&left, &right);
+    order(&top, &bottom);
+    span(t, top, left, right, color);
+    if (bottom != top) span(t, bottom, left, right, color);
+    int y0 = (top + 1 < t->clipTop) ? t->clipTop : top + 1;
+    int y1 = (bottom - 1 > t->clipBottom) ? t->clipBottom : bottom - 1;
+    for (int y = y0; y <= y1; y++) {
+        pixel(t, left, y, color);
+        if (right != left) pixel(t, right, y, color);
+    }
+}
+
+// 外接框 [left, right] x [top, bottom] 的椭圆在第 y 行覆盖的 [x0, x1]，不覆盖返回 0
+static int ellipseRow(int left, int top, int right, int bottom, int y, int* x0, int* x1) {
+    if (y < top || y > bottom) return 0;
+    double cx = (left + right) * 0.5, cy = (top + bottom) * 0.5;
+    double a = (right - left) * 0.5 + 0.5, b = (bottom - top) * 0.5 + 0.5;
+    double dy = (y - cy) / b;
+    double half = a * sqrt(1.0 - dy * dy);
+    *x0 = (int)ceil(cx - half);
+    *x1 = (int)floor(cx + half);
+    if (*x0 < left) *x0 = left;
+    if (*x1 > right) *x1 = right;
+    return *x0 <= *x1;
+}
+
+static void softSolidEllipse(void* impl, int left, int top, int right, int bottom, RRColor color) {
+    RRSoftTarget* t = (RRSoftTarget*)impl;
+    order(&left, &right);
+    order(&top, &bottom);
+    int y0 = (top < t->clipTop) ? t->clipTop : top;
+    int y1 = (bottom > t->clipBottom) ? t->clipBottom : bottom;
+    for (int y = y0; y <= y1; y++) {
+        int x0, x1;
+        if (ellipseRow(left, top, right, bottom, y, &x0, &x1)) span(t, y, x0, x1, color);
+    }
+}
+
+// 边框 = 填充区域里上下左右有邻居在外面的像素: 每行左右两端各一段
+static void softEllipse(void* impl, int left, int top, int right, int bottom, RRColor color) {
+    RRSoftTarget* t = (RRSoftTarget*)impl;
+    order(&left, &right);
+    order(&top, &bottom);
+    int y0 = (top < t->clipTop) ? t->clipTop : top;
+    int y1 = (bottom > t->clipBottom) ? t->clipBottom : bottom;
+    for (int y = y0; y <= y1; y++) {
+        int x0, x1;
+        if (!ellipseRow(left, top, right, bottom, y, &x0, &x1)) continue;
+
+        // 上下两行里较窄的那行决定这一行有多少像素露在外面
+        int innerL = INT32_MAX, innerR = INT32_MIN;
+        int a0, a1, b0, b1;
+        if (ellipseRow(left, top, right, bottom, y - 1, &a0, &a1) &&
+            ellipseRow(left, top, right, bottom, y + 1, &b0, &b1)) {
+            innerL = (a0 > b0) ? a0 : b0;
+            innerR = (a1 < b1) ? a1 : b1;
+        }
+        if (innerL > innerR) {
+            span(t, y, x0, x1, color);
+            continue;
+        }
+        int leftEnd = (innerL - 1 > x0) ? innerL - 1 : x0;
+        int rightStart = (innerR + 1 < x1) ? innerR + 1 : x1;
+        span(t, y, x0, leftEnd, color);
+        span(t, y, rightStart, x1, color);
+    }
+}
+
+static void softSolidCircle(void* impl, int x, int y, int radius, RRColor color) {
+    RRSoftTarget* t = (RRSoftTarget*)impl;
+    int r2 = radius * radius + radius;     // 半径取 r + 0.5 左右，小圆不至于变成菱形
+    int half = radius;
+    for (int dy = 0; dy <= radius; dy++) {
+        while (half > 0 && half * half + dy * dy > r2) half--;
+        span(t, y - dy, x - half, x + half, color);
+        if (dy != 0) span(t, y + dy, x - half, x + half, color);
+    }
+}
+
+// 扫描线填充 (奇偶规则)，像素中心 y 与边求交，含边界
+static void softSolidPolygon(void* impl, const RRPoint* points, int count, RRColor color) {
+    RRSoftTarget* t = (RRSoftTarget*)impl;
+    if (count < 3) return;
+
+    int minY = points[0].y, maxY = points[0].y;
+    for (int i = 1; i < count; i++) {
+        if (points[i].y < minY) minY = points[i].y;
+        if (points[i].y > maxY) maxY = points[i].y;
+    }
+    if (minY < t->clipTop) minY = t->clipTop;
+    if (maxY > t->clipBottom) maxY = t->clipBottom;
+
+    double xs[64];
+    for (int y = minY; y <= maxY; y++) {
+        int n = 0;
+        double cy = y + 0.5;
+        for (int i = 0; i < count && n < 64; i++) {
+            const RRPoint* a = &points[i];
+            const RRPoint* b = &points[(i + 1) % count];
+            if ((a->y <= cy && b->y > cy) || (b->y <= cy && a->y > cy)) {
+                xs[n++] = a->x + (cy - a->y) * (b->x - a->x) / (double)(b->y - a->y);
+            }
+        }
+        // 交点很少，插入排序
+        for (int i = 1; i < n; i++) {
+            double v = xs[i];
+            int j = i - 1;
+            while (j >= 0 && xs[j] > v) {
+                xs[j + 1] = xs[j];
+                j--;
+            }
+            xs[j + 1] = v;
+        }
+        for (int i = 0; i + 1 < n; i += 2) {
+            span(t, y, (int)ceil(xs[i] - 0.5), (int)floor(xs[i + 1] - 0.5), color);
+        }
+    }
+}
+
+// Bresenham
+static void softLine(void* impl, int x1, int y1, int x2, int y2, RRColor color) {
+    RRSoftTarget* t = (RRSoftTarget*)impl;
+    if (y1 == y2) {
+        order(&x1, &x2);
+        span(t, y1, x1, x2, color);
+        return;
+    }
+    int dx = abs(x2 - x1), sx = (x1 < x2) ? 1 : -1;
+    int dy = -abs(y2 - y1), sy = (y1 < y2) ? 1 : -1;
+    int err = dx + dy;
+    for (;;) {
+        pixel(t, x1, y1, color);
+        if (x1 == x2 && y1 == y2) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x1 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y1 += sy;
+        }
+    }
+}
+
+// --- 文字 (占位字形) ---
+// 取出下一个字，返回它的编码，*wide = 全角 (UTF-8 多字节)
+static unsigned nextChar(const char** s, int* wide) {
+    const unsigned char* p = (const unsigned char*)*s;
+    unsigned c = *p++;
+    *wide = 0;
+    if (c >= 0xC0) {
+        *wide = 1;
+        while ((*p & 0xC0) == 0x80) c = (c << 6) ^ *p++;
+    }
+    *s = (const char*)p;
+    return c;
+}
+
+static int charWidth(int wide, int height) {
+    return wide ? height : height / 2;
+}
+
+static void drawGlyph(RRSoftTarget* t, int x, int y, unsigned code, int wide, int height, RRColor color) {
+    int width = charWidth(wide, height);
+    softSolidRect(t, x, y, x + width - 1, y + height - 1, RR_RGB(0, 0, 0));
+    if (code == ' ') return;
+
+    // 格子里的图案由字的编码决定，大约一半的格子点亮
+    int cols = wide ? GLYPH_COLS * 2 : GLYPH_COLS;
+    int cellW = (width - 2) / cols, cellH = (height - 2) / GLYPH_ROWS;
+    if (cellW < 1) cellW = 1;
+    if (cellH < 1) cellH = 1;
+    uint32_t bits = code * 0x9E3779B1u;
+    for (int row = 0; row < GLYPH_ROWS; row++) {
+        for (int col = 0; col < cols; col++) {
+            bits ^= bits << 13;
+            bits ^= bits >> 17;
+            bits ^= bits << 5;
+            if (bits & 1) {
+                int px = x + 1 + col * cellW, py = y + 1 + row * cellH;
+                softSolidRect(t, px, py, px + cellW - 1, py + cellH - 1, color);
+            }
+        }
+    }
+}
+
+static void softText(void* impl, int x, int y, const char* text, int height, RRColor color) {
+    RRSoftTarget* t = (RRSoftTarget*)impl;
+    if (y > t->clipBottom || y + height + GLYPH_ROWS < t->clipTop) return;
+    // 裁剪框外的字不画 (格子至少 1 像素，小字号时可能比字宽多出几个像素，多留一点)
+    while (*text && x <= t->clipRight) {
+        int wide;
+        unsigned code = nextChar(&text, &wide);
+        int width = charWidth(wide, height);
+        if (x + width + GLYPH_COLS * 2 >= t->clipLeft) drawGlyph(t, x, y, code, wide, height, color);
+        x += width;
+    }
+}
+
+static int softTextWidth(void*, const char* text, int height) {
+    int width = 0;
+    while (*text) {
+        int wide;
+        nextChar(&text, &wide);
+        width += charWidth(wide, height);
+    }
+    return width;
+}
+
+static void softSetClip(void* impl, int left, int top, int right, int bottom) {
+    RRSoftTarget* t = (RRSoftTarget*)impl;
+    t->clipLeft = (left < 0) ? 0 : left;
+    t->clipTop = (top < 0) ? 0 : top;
+    t->clipRight = (right >= t->width) ? t->width - 1 : right;
+    t->clipBottom = (bottom >= t->height) ? t->height - 1 : bottom;
+}
+
+// --- 图层 ---
+typedef struct {
+    uint32_t* pixels;
+    int width, height;
+} SoftLayer;
+
+static void* softCreateLayer(void*, int width, int height) {
+    SoftLayer* layer = (SoftLayer*)malloc(sizeof(SoftLayer));
+    if (layer == NULL) return NULL;
+    layer->pixels = (uint32_t*)calloc((size_t)width * height, sizeof(uint32_t));
+    if (layer->pixels == NULL) {
+        free(layer);
+        return NULL;
+    }
+    layer->width = width;
+    layer->height = height;
+    return layer;
+}
+
+static void softFreeLayer(void*, void* layer) {
+    if (layer == NULL) return;
+    free(((SoftLayer*)layer)->pixels);
+    free(layer);
+}
+
+static void softBeginLayer(void* impl, void* layer) {
+    RRSoftTarget* t = (RRSoftTarget*)impl;
+    if (t->screen == NULL) {
+        t->screen = t->pixels;
+        t->screenWidth = t->width;
+        t->screenHeight = t->height;
+        t->screenStride = t->stride;
+    }
+    if (layer != NULL) {
+        SoftLayer* l = (SoftLayer*)layer;
+        t->pixels = l->pixels;
+        t->width = t->stride = l->width;
+        t->height = l->height;
+    } else {
+        t->pixels = t->screen;
+        t->width = t->screenWidth;
+        t->height = t->screenHeight;
+        t->stride = t->screenStride;
+        t->screen = NULL;
+    }
+    softSetClip(t, 0, 0, t->width - 1, t->height - 1);
+}
+
+// 整行 memcpy，只受裁剪框限制
+static void softDrawLayer(void* impl, void* layer, int x, int y, int width, int height) {
+    RRSoftTarget* t = (RRSoftTarget*)impl;
+    const SoftLayer* l = (const SoftLayer*)layer;
+    if (width > l->width) width = l->width;
+    if (height > l->height) height = l->height;
+    int x0 = (x > t->clipLeft) ? x : t->clipLeft;
+    int x1 = (x + width - 1 < t->clipRight) ? x + width - 1 : t->clipRight;
+    int y0 = (y > t->clipTop) ? y : t->clipTop;
+    int y1 = (y + height - 1 < t->clipBottom) ? y + height - 1 : t->clipBottom;
+    if (x0 > x1) return;
+
+    int n = x1 - x0 + 1;
+    for (int row = y0; row <= y1; row++) {
+        memcpy(t->pixels + (size_t)row * t->stride + x0, l->pixels + (size_t)(row - y) * l->width + (x0 - x),
+               sizeof(uint32_t) * n);
+        t->pixelsWritten += n;
+    }
+}
+
+static void softPresent(void* impl) {
+    RRSoftTarget* t = (RRSoftTarget*)impl;
+    t->frames++;
+}
+
+static const RRRenderOps softOps = {
+    softClear,
+    softSolidRect,
+    softRect,
+    softSolidEllipse,
+    softEllipse,
+    softSolidCircle,
+    softSolidPolygon,
+    softLine,
+    softText,
+    softTextWidth,
+    softSetClip,
+    softCreateLayer,
+    softFreeLayer,
+    softBeginLayer,
+    softDrawLayer,
+    softPresent
+};
+
+int rrSoftInit(RRRenderer* r, RRSoftTarget* t, int width, int height) {
+    memset(t, 0, sizeof(RRSoftTarget));
+    t->pixels = (uint32_t*)calloc((size_t)width * height, sizeof(uint32_t));
+    if (t->pixels == NULL) return 0;
+    t->width = width;
+    t->height = height;
+    t->stride = width;
+    softSetClip(t, 0, 0, width - 1, height - 1);
+    rrSoftAttach(r, t);
+    return 1;
+}
+
+void rrSoftAttach(RRRenderer* r, RRSoftTarget* t) {
+    rrRendererInit(r, &softOps, t, t->width, t->height);
+}
+
+void rrSoftFree(RRSoftTarget* t) {
+    free(t->pixels);
+    t->pixels = NULL;
+}
+
+// --- BMP (小端写入，自下而上) ---
+static void put16(unsigned char* p, unsigned v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+}
+
+static void put32(unsigned char* p, unsigned v) {
+    put16(p, v & 0xFFFF);
+    put16(p + 2, v >> 16);
+}
+
+int rrSoftSaveBMP(const RRSoftTarget* t, const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return 0;
+
+    unsigned imageSize = (unsigned)t->width * t->height * 4;
+    unsigned char header[54];
+    memset(header, 0, sizeof(header));
+    header[0] = 'B';
+    header[1] = 'M';
+    put32(header + 2, 54 + imageSize);
+    put32(header + 10, 54);
+    put32(header + 14, 40);
+    put32(header + 18, (unsigned)t->width);
+    put32(header + 22, (unsigned)t->height);
+    put16(header + 26, 1);
+    put16(header + 28, 32);
+    put32(header + 34, imageSize);
+    fwrite(header, 1, sizeof(header), f);
+
+    unsigned char* row = (unsigned char*)malloc((size_t)t->width * 4);
+    if (row == NULL) {
+        fclose(f);
+        return 0;
+    }
+    for (int y = t->height - 1; y >= 0; y--) {
+        const uint32_t* src = t->pixels + (size_t)y * t->stride;
+        for (int x = 0; x < t->width; x++) put32(row + x * 4, src[x]);
+        fwrite(row, 4, t->width, f);
+    }
+    free(row);
+    return fclose(f) == 0;
+}
@@ -0,0 +1,36 @@
+/*
+ * 文件名: rr_render_soft.h
+ * 描述: 绘制后端的纯 CPU 实现: 画到内存里的 BGRA 帧缓冲，不依赖任何图形库，Linux 上也能编译
+ *       用于无界面地跑完整绘制路径，测每个画面的帧耗时和填充带宽
+ *       文字没有字库，每个字画成固定图案的方块 (覆盖率与真实字形相近，但不可读)；
+ *       背景按 EasyX 默认的 OPAQUE 模式填成黑色，和游戏里看到的一致
+ *       图层就是另一块同格式的像素缓冲，画图层时把 pixels / width / height 临时换成它的
+ */
+#ifndef RR_RENDER_SOFT_H
+#define RR_RENDER_SOFT_H
+
+#include <stdint.h>
+
+#include "rr_render.h"
+
+typedef struct {
+    uint32_t* pixels;           // 0x00RRGGBB，每行 stride 个像素
+    int width, height, stride;
+    int clipLeft, clipTop, clipRight, clipBottom;   // 裁剪框 (含两端)
+    uint32_t* screen;           // 画图层时屏幕缓冲存在这里，pixels 等指向图层；NULL = 正在画屏幕
+    int screenWidth, screenHeight, screenStride;
+    long long pixelsWritten;    // 累计写过的像素数 (填充带宽)
+    int frames;                 // 累计 present 次数
+} RRSoftTarget;
+
+// 分配帧缓冲并把 r 接到它上面，成功返回 1
+int rrSoftInit(RRRenderer* r, RRSoftTarget* t, int width, int height);
+// 把 r 接到已有的 t 上 (不分配)；t 可以是另一块目标的浅拷贝: 共享像素，裁剪框和统计各自一份，
+// 这样几个线程可以各画帧缓冲里互不相交的一块 (见 rr_tile)
+void rrSoftAttach(RRRenderer* r, RRSoftTarget* t);
+void rrSoftFree(RRSoftTarget* t);
+
+// 存成 32 位 BMP (查看画面用)，成功返回 1
+int rrSoftSaveBMP(const RRSoftTarget* t, const char* path);
+
+#endif
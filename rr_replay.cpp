@@ -0,0 +1,266 @@
+/*
+ * 文件名: rr_replay.cpp
+ * 描述: 录像的录制、读写与回放
+ *
+ * 文件格式 (全部整数为 LEB128 变长编码):
+ *   "RRPL" 版本(1字节) 角色(1字节) 难度(1字节)
+ *   种子 结束步数 结束分数 拍数 循环步数
+ *   拍: 与上一拍的步数差
+ *   事件数
+ *   事件: (与上一事件的步数差 << 2) | 事件类型
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rr_replay.h"
+
+#define REPLAY_HEADER_MAX 64
+
+// --- 变长整数 ---
+static int writeVarint(unsigned char* buf, unsigned long long v) {
+    int n = 0;
+    while (v >= 0x80) {
+        buf[n++] = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    buf[n++] = (unsigned char)v;
+    return n;
+}
+
+// 读失败 (越界或超长) 返回 0
+static int readVarint(const unsigned char* buf, int size, int* pos, unsigned long long* out) {
+    unsigned long long v = 0;
+    int shift = 0;
+    while (*pos < size && shift < 64) {
+        unsigned char b = buf[(*pos)++];
+        v |= (unsigned long long)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *out = v;
+            return 1;
+        }
+        shift += 7;
+    }
+    return 0;
+}
+
+// --- 录制 ---
+void rrReplayInit(RRReplay* r, CharacterType charType, DifficultyLevel level, unsigned long long seed) {
+    r->charType = charType;
+    r->level = level;
+    r->seed = seed;
+    r->finalTick = 0;
+    r->finalScore = 0;
+    r->beatTicks = NULL;
+    r->beatCount = 0;
+    r->beatLoopTicks = 0;
+    r->events = NULL;
+    r->eventCount = 0;
+    r->eventCapacity = 0;
+    r->duckHeld = 0;
+}
+
+static void pushEvent(RRReplay* r, int tick, int type) {
+    if (r->eventCount == r->eventCapacity) {
+        int capacity = r->eventCapacity ? r->eventCapacity * 2 : 64;
+        RREvent* events = (RREvent*)realloc(r->events, sizeof(RREvent) * capacity);
+        if (events == NULL) return;
+        r->events = events;
+        r->eventCapacity = capacity;
+    }
+    r->events[r->eventCount].tick = tick;
+    r->events[r->eventCount].type = type;
+    r->eventCount++;
+}
+
+void rrReplaySetBeats(RRReplay* r, const int* ticks, int count, int loopTicks) {
+    free(r->beatTicks);
+    r->beatTicks = NULL;
+    r->beatCount = 0;
+    r->beatLoopTicks = loopTicks;
+    if (count <= 0) return;
+
+    r->beatTicks = (int*)malloc(sizeof(int) * count);
+    if (r->beatTicks == NULL) return;
+    memcpy(r->beatTicks, ticks, sizeof(int) * count);
+    r->beatCount = count;
+}
+
+void rrReplayRecord(RRReplay* r, const RRWorld* w, const RRInput* in) {
+    int tick = w->frameCount;
+
+    // 空中按跳跃没有效果，不必记录 (按住空格的自动连发全部省掉)
+    if (in->jump && !w->dino.isJumping) {
+        pushEvent(r, tick, RR_EVENT_JUMP);
+    }
+    if (in->duck && !r->duckHeld) {
+        pushEvent(r, tick, RR_EVENT_DUCK_DOWN);
+    } else if (!in->duck && r->duckHeld) {
+        pushEvent(r, tick, RR_EVENT_DUCK_UP);
+    }
+    r->duckHeld = in->duck ? 1 : 0;
+}
+
+void rrReplayFinish(RRReplay* r, const RRWorld* w) {
+    r->finalTick = w->frameCount;
+    r->finalScore = w->score;
+}
+
+void rrReplayFree(RRReplay* r) {
+    free(r->beatTicks);
+    r->beatTicks = NULL;
+    r->beatCount = 0;
+    free(r->events);
+    r->events = NULL;
+    r->eventCount = 0;
+    r->eventCapacity = 0;
+}
+
+// --- 文件 ---
+int rrReplaySave(const RRReplay* r, const char* path) {
+    // 每个事件、每拍最多 5 字节
+    int size = REPLAY_HEADER_MAX + (r->eventCount + r->beatCount) * 5;
+    unsigned char* buf = (unsigned char*)malloc(size);
+    if (buf == NULL) return 0;
+
+    int n = 0;
+    memcpy(buf, RR_REPLAY_MAGIC, 4);
+    n += 4;
+    buf[n++] = RR_REPLAY_VERSION;
+    buf[n++] = (unsigned char)r->charType;
+    buf[n++] = (unsigned char)r->level;
+    n += writeVarint(buf + n, r->seed);
+    n += writeVarint(buf + n, (unsigned long long)r->finalTick);
+    n += writeVarint(buf + n, (unsigned long long)r->finalScore);
+    n += writeVarint(buf + n, (unsigned long long)r->beatCount);
+    n += writeVarint(buf + n, (unsigned long long)r->beatLoopTicks);
+
+    int lastBeat = 0;
+    for (int i = 0; i < r->beatCount; i++) {
+        n += writeVarint(buf + n, (unsigned long long)(r->beatTicks[i] - lastBeat));
+        lastBeat = r->beatTicks[i];
+    }
+    n += writeVarint(buf + n, (unsigned long long)r->eventCount);
+
+    int lastTick = 0;
+    for (int i = 0; i < r->eventCount; i++) {
+        unsigned long long delta = (unsigned long long)(r->events[i].tick - lastTick);
+        n += writeVarint(buf + n, (delta << 2) | (unsigned long long)r->events[i].type);
+        lastTick = r->events[i].tick;
+    }
+
+    FILE* fp = fopen(path, "wb");
+    int ok = 0;
+    if (fp != NULL) {
+        ok = (fwrite(buf, 1, n, fp) == (size_t)n);
+        fclose(fp);
+    }
+    free(buf);
+    return ok;
+}
+
+int rrReplayLoad(RRReplay* r, const char* path) {
+    FILE* fp = fopen(path, "rb");
+    if (fp == NULL) return 0;
+
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size < 7) {
+        fclose(fp);
+        return 0;
+    }
+
+    unsigned char* buf = (unsigned char*)malloc(size);
+    if (buf == NULL || fread(buf, 1, size, fp) != (size_t)size) {
+        free(buf);
+        fclose(fp);
+        return 0;
+    }
+    fclose(fp);
+
+    int ok = 0;
+    int pos = 7;
+    unsigned long long seed, finalTick, finalScore, beatCount, beatLoop, count;
+    if (memcmp(buf, RR_REPLAY_MAGIC, 4) == 0 && buf[4] == RR_REPLAY_VERSION &&
+        buf[5] < CHAR_COUNT && buf[6] < LEVEL_COUNT &&
+        readVarint(buf, (int)size, &pos, &seed) &&
+        readVarint(buf, (int)size, &pos, &finalTick) &&
+        readVarint(buf, (int)size, &pos, &finalScore) &&
+        readVarint(buf, (int)size, &pos, &beatCount) && beatCount <= (unsigned long long)size &&
+        readVarint(buf, (int)size, &pos, &beatLoop)) {
+
+        rrReplayInit(r, (CharacterType)buf[5], (DifficultyLevel)buf[6], seed);
+        r->finalTick = (int)finalTick;
+        r->finalScore = (int)finalScore;
+        r->beatLoopTicks = (int)beatLoop;
+
+        ok = 1;
+        if (beatCount > 0) {
+            r->beatTicks = (int*)malloc(sizeof(int) * beatCount);
+            ok = (r->beatTicks != NULL);
+        }
+        int beat = 0;
+        for (unsigned long long i = 0; ok && i < beatCount; i++) {
+            unsigned long long v;
+            if (!readVarint(buf, (int)size, &pos, &v)) {
+                ok = 0;
+                break;
+            }
+            beat += (int)v;
+            r->beatTicks[r->beatCount++] = beat;
+        }
+        if (ok && (!readVarint(buf, (int)size, &pos, &count) || count > (unsigned long long)size)) ok = 0;
+
+        int tick = 0;
+        for (unsigned long long i = 0; ok && i < count; i++) {
+            unsigned long long v;
+            if (!readVarint(buf, (int)size, &pos, &v) || (v & 3) > RR_EVENT_DUCK_UP) {
+                ok = 0;
+                break;
+            }
+            tick += (int)(v >> 2);
+            pushEvent(r, tick, (int)(v & 3));
+        }
+        if (!ok) rrReplayFree(r);
+    }
+
+    free(buf);
+    return ok;
+}
+
+// --- 回放 ---
+void rrReplayPlayerInit(RRReplayPlayer* p, const RRReplay* r) {
+    p->replay = r;
+    p->next = 0;
+    p->duck = 0;
+}
+
+void rrReplayPlayerInput(RRReplayPlayer* p, int tick, RRInput* out) {
+    const RRReplay* r = p->replay;
+
+    out->jump = 0;
+    while (p->next < r->eventCount && r->events[p->next].tick <= tick) {
+        switch (r->events[p->next].type) {
+            case RR_EVENT_JUMP: out->jump = 1; break;
+            case RR_EVENT_DUCK_DOWN: p->duck = 1; break;
+            case RR_EVENT_DUCK_UP: p->duck = 0; break;
+        }
+        p->next++;
+    }
+    out->duck = p->duck;
+}
+
+int rrReplayRun(const RRReplay* r, RRWorld* w) {
+    RRReplayPlayer player;
+    RRInput input;
+
+    rrInitWorld(w, r->charType, r->level, r->seed);
+    rrSetBeatTrack(w, r->beatTicks, r->beatCount, r->beatLoopTicks);
+    rrReplayPlayerInit(&player, r);
+    while (!w->gameOver && w->frameCount < r->finalTick) {
+        rrReplayPlayerInput(&player, w->frameCount, &input);
+        rrStep(w, &input);
+    }
+    return w->frameCount == r->finalTick && w->score == r->finalScore;
+}
@@ -0,0 +1,67 @@
+/*
+ * 文件名: rr_replay.h
+ * 描述: 录像 (种子 + 带时间戳的输入事件)，变长整数 + 差分编码，一局只有几百字节
+ *       回放走的是和键盘输入相同的 rrStep 路径，可实时播放也可无界面快进
+ */
+#ifndef RR_REPLAY_H
+#define RR_REPLAY_H
+
+#include "rr_core.h"
+
+#define RR_REPLAY_MAGIC "RRPL"
+#define RR_REPLAY_VERSION 4    // 模拟规则变化时递增，旧录像无法复现
+
+// --- 输入事件类型 ---
+typedef enum {
+    RR_EVENT_JUMP = 0,       // VK_SPACE 按下 (且确实起跳)
+    RR_EVENT_DUCK_DOWN = 1,  // VK_DOWN 按下
+    RR_EVENT_DUCK_UP = 2     // VK_DOWN 松开
+} RREventType;
+
+typedef struct {
+    int tick;               // 发生在第几步 (rrStep 之前的 frameCount)
+    int type;               // RREventType
+} RREvent;
+
+// --- 一局录像 ---
+typedef struct {
+    CharacterType charType;
+    DifficultyLevel level;
+    unsigned long long seed;
+    int finalTick;          // 结束时的步数 (用于校验)
+    int finalScore;         // 结束时的分数 (用于校验最高分)
+
+    int* beatTicks;         // 节拍模式的拍子 (NULL = 随机生成)，录像自带一份
+    int beatCount;
+    int beatLoopTicks;
+
+    RREvent* events;
+    int eventCount;
+    int eventCapacity;
+    int duckHeld;           // 录制时当前的下蹲状态
+} RRReplay;
+
+// --- 回放游标 ---
+typedef struct {
+    const RRReplay* replay;
+    int next;               // 下一个要播放的事件
+    int duck;               // 当前下蹲状态
+} RRReplayPlayer;
+
+// --- 录制 ---
+void rrReplayInit(RRReplay* r, CharacterType charType, DifficultyLevel level, unsigned long long seed);
+void rrReplaySetBeats(RRReplay* r, const int* ticks, int count, int loopTicks); // 复制一份
+void rrReplayRecord(RRReplay* r, const RRWorld* w, const RRInput* in); // 在 rrStep 之前调用
+void rrReplayFinish(RRReplay* r, const RRWorld* w);
+void rrReplayFree(RRReplay* r);
+
+// --- 文件 (成功返回 1) ---
+int rrReplaySave(const RRReplay* r, const char* path);
+int rrReplayLoad(RRReplay* r, const char* path);
+
+// --- 回放 ---
+void rrReplayPlayerInit(RRReplayPlayer* p, const RRReplay* r);
+void rrReplayPlayerInput(RRReplayPlayer* p, int tick, RRInput* out);
+int rrReplayRun(const RRReplay* r, RRWorld* w);   // 无界面快进到结尾，结果与录制一致返回 1
+
+#endif
@@ -0,0 +1,53 @@
+/*
+ * 文件名: rr_replay_tool.cpp
+ * 描述: 录像命令行工具 (无界面快进回放)
+ *       校验录像的结束步数和分数 (复现玩家报告、核对最高分)，并测回放速度
+ * 编译: g++ -O2 -std=c++11 rr_replay_tool.cpp rr_replay.cpp rr_core.cpp rr_collide.cpp -o rr_replay_tool
+ * 用法: rr_replay_tool 录像文件.rrp [重复次数=1]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+#include "rr_replay.h"
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printf("用法: rr_replay_tool 录像文件.rrp [重复次数]\n");
+        return 1;
+    }
+    int repeat = (argc > 2) ? atoi(argv[2]) : 1;
+    if (repeat < 1) repeat = 1;
+
+    RRReplay replay;
+    if (!rrReplayLoad(&replay, argv[1])) {
+        printf("无法读取录像: %s\n", argv[1]);
+        return 1;
+    }
+
+    printf("角色: %s  难度: %s  种子: %llu\n",
+           charConfigs[replay.charType].name, levelConfigs[replay.level].name, replay.seed);
+    printf("录制结果: %d 步 (%.1f 秒), %d 分, %d 个输入事件\n",
+           replay.finalTick, replay.finalTick / 60.0, replay.finalScore, replay.eventCount);
+    if (replay.beatCount > 0) {
+        printf("节拍模式: %d 拍, 循环 %d 步\n", replay.beatCount, replay.beatLoopTicks);
+    }
+
+    RRWorld world;
+    int ok = 1;
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++) {
+        ok &= rrReplayRun(&replay, &world);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    printf("回放结果: %d 步, %d 分, %s\n", world.frameCount, world.score, world.gameOver ? "死亡" : "未死亡");
+    printf("校验: %s\n", ok ? "一致" : "不一致!");
+    if (seconds > 0) {
+        double steps = (double)world.frameCount * repeat;
+        printf("速度: %.0f 步/秒 (实时的 %.0f 倍)\n", steps / seconds, steps / seconds / 60.0);
+    }
+
+    rrReplayFree(&replay);
+    return ok ? 0 : 2;
+}
@@ -0,0 +1,65 @@
+/*
+ * 文件名: rr_snapshot.cpp
+ * 描述: 三缓冲的世界快照
+ *       latest 的低两位是最新那份的下标，FRESH 位表示渲染线程还没取走
+ *       发布: 写好的下标带 FRESH 换进 latest，换出来的旧 "最新" 成为下一次写的那份
+ *       读取: 有 FRESH 才把自己那份换进去；交换用 acq_rel，写的内容在读到下标前可见
+ */
+#include <atomic>
+#include <new>
+
+#include "rr_snapshot.h"
+
+#define FRESH 4
+
+struct RRSnapshotBuffer {
+    RRSnapshot slots[3];
+    std::atomic<int> latest;
+    int writing;            // 只有模拟线程用
+    int reading;            // 只有渲染线程用
+    int readAny;
+};
+
+RRSnapshotBuffer* rrSnapshotCreate() {
+    RRSnapshotBuffer* b = new (std::nothrow) RRSnapshotBuffer;
+    if (b == NULL) return NULL;
+    b->latest.store(1);
+    b->writing = 0;
+    b->reading = 2;
+    b->readAny = 0;
+    return b;
+}
+
+void rrSnapshotFree(RRSnapshotBuffer* b) {
+    delete b;
+}
+
+RRSnapshot* rrSnapshotWrite(RRSnapshotBuffer* b) {
+    return &b->slots[b->writing];
+}
+
+void rrSnapshotPublish(RRSnapshotBuffer* b) {
+    b->writing = b->latest.exchange(b->writing | FRESH, std::memory_order_acq_rel) & 3;
+}
+
+const RRSnapshot* rrSnapshotRead(RRSnapshotBuffer* b, int* fresh) {
+    *fresh = 0;
+    if (b->latest.load(std::memory_order_relaxed) & FRESH) {
+        b->reading = b->latest.exchange(b->reading, std::memory_order_acq_rel) & 3;
+        b->readAny = 1;
+        *fresh = 1;
+    }
+    return b->readAny ? &b->slots[b->reading] : NULL;
+}
+
+void rrSnapshotScene(const RRSnapshot* s, RRScene* scene, double alpha) {
+    scene->state = s->state;
+    scene->selectedChar = s->selectedChar;
+    scene->selectedLevel = s->selectedLevel;
+    scene->highScore = s->highScore;
+    scene->newRecord = s->newRecord;
+    scene->nightMode = s->nightMode;
+    scene->autoplay = s->autoplay;
+    scene->replayMode = s->replayMode;
+    rrSceneInterpolate(scene, &s->prev, &s->cur, alpha);
+}
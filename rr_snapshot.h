@@ -0,0 +1,46 @@
+/*
+ * 文件名: rr_snapshot.h
+ * 描述: 模拟线程到渲染线程的世界快照，三缓冲、无锁
+ *       模拟线程写自己独占的那一份，写完和 "最新" 交换；渲染线程有新的就把自己那份和 "最新" 交换
+ *       三份各归一方，写的一方永远不等读的一方，渲染慢了只是跳过中间的快照
+ *       快照发布后就不再改动，渲染线程可以画多少帧都读同一份 (按时间插值)
+ */
+#ifndef RR_SNAPSHOT_H
+#define RR_SNAPSHOT_H
+
+#include "rr_core.h"
+#include "rr_draw.h"
+
+// --- 画一帧需要的全部模拟状态 ---
+typedef struct {
+    GameState state;
+    CharacterType selectedChar;
+    DifficultyLevel selectedLevel;
+    int highScore;
+    int newRecord;
+    int nightMode;
+    int autoplay;
+    int replayMode;
+    RRWorld prev;           // 上一步和当前步，渲染线程在两者之间插值
+    RRWorld cur;
+    double time;            // cur 这一步在模拟时钟上的时刻 (秒)，插值系数 = (现在 - time) / 步长
+} RRSnapshot;
+
+typedef struct RRSnapshotBuffer RRSnapshotBuffer;
+
+RRSnapshotBuffer* rrSnapshotCreate();
+void rrSnapshotFree(RRSnapshotBuffer* b);
+
+// --- 模拟线程 ---
+// 取可以写的那一份 (内容是更早的某个快照，要整份填好)，填完调 rrSnapshotPublish
+RRSnapshot* rrSnapshotWrite(RRSnapshotBuffer* b);
+void rrSnapshotPublish(RRSnapshotBuffer* b);
+
+// --- 渲染线程 ---
+// 最新发布的快照；上次之后没有新的就还是上次那份 (fresh 置 0)，还没发布过返回 NULL
+const RRSnapshot* rrSnapshotRead(RRSnapshotBuffer* b, int* fresh);
+
+// 快照填进 RRScene (layers、hud 不动)，alpha 是插值系数 (0~1)
+void rrSnapshotScene(const RRSnapshot* s, RRScene* scene, double alpha);
+
+#endif
@@ -0,0 +1,220 @@
+/*
+ * 文件名: rr_sync_tool.cpp
+ * 描述: 跨平台确定性检查 (无界面)
+ *       按固定脚本跑一批局: 角色 x 难度 x 重力等级 x 输入脚本 x 种子，外加节拍模式
+ *       输入脚本: 机器人 / 随机乱按 (含蹲着起跳等不在轨迹表上的情况) / 幽灵局乱按 (恐龙不参与碰撞，跑满全程)
+ *       每步把 rrWorldHash 串成链，每 CHECK_TICKS 步记一个检查点
+ *       在一台机器上 write 记下结果，拿到另一个平台 / 编译器 / 优化级别下 check，
+ *       不一致时报告第一个出现分歧的局和步数区间
+ * 编译: g++ -O2 -std=c++11 rr_sync_tool.cpp rr_bot.cpp rr_core.cpp rr_collide.cpp -o rr_sync_tool
+ * 用法: rr_sync_tool write 结果文件 [每组种子数=1] [每局最大步数=36000] [种子=1]
+ *       rr_sync_tool check 结果文件
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rr_bot.h"
+
+#define SYNC_MAGIC "RRSYNC"
+#define SYNC_VERSION 1
+#define CHECK_TICKS 600             // 检查点间隔 (10 秒)
+#define MAX_CHECKS 1024
+#define SYNC_STREAM_INPUT 16        // 乱按脚本用的随机数流 (与游戏的流错开)
+#define BEAT_COUNT 64
+
+// --- 输入脚本 ---
+typedef enum {
+    SCRIPT_BOT = 0,
+    SCRIPT_MASH = 1,
+    SCRIPT_GHOST = 2,
+    SCRIPT_COUNT
+} ScriptType;
+
+const char* scriptNames[SCRIPT_COUNT] = {"bot", "mash", "ghost"};
+
+// --- 一局的结果 ---
+typedef struct {
+    char name[64];
+    int finalTick;
+    int score;
+    int checkCount;
+    uint64_t checks[MAX_CHECKS];    // 第 k 个 = 前 (k+1)*CHECK_TICKS 步的哈希链 (最后一个是结束时)
+} SyncRun;
+
+// 乱按: 偶尔跳，偶尔切换下蹲
+static void mashInput(RRRng* rng, int* duck, RRInput* in) {
+    in->jump = (rrRngRange(rng, 20) == 0);
+    if (rrRngRange(rng, 30) == 0) *duck = !*duck;
+    in->duck = *duck;
+}
+
+static void runScenario(SyncRun* r, CharacterType ch, DifficultyLevel lv, int gravityLevel,
+                        int script, unsigned long long seed, const int* beats, int beatLoop, int maxSteps) {
+    RRWorld world;
+    RRBot bot;
+    RRRng inputRng;
+    RRInput input;
+    int duck = 0;
+
+    rrInitWorld(&world, ch, lv, seed);
+    world.gravityLevel = gravityLevel;
+    if (beats) rrSetBeatTrack(&world, beats, BEAT_COUNT, beatLoop);
+    if (script == SCRIPT_GHOST) {
+        world.dino.x = -2 * WIN_WIDTH;
+        world.fairMode = RR_FAIR_REPORT;
+    }
+    rrBotInit(&bot);
+    rrRngSeed(&inputRng, seed, SYNC_STREAM_INPUT);
+
+    uint64_t chain = rrWorldHash(&world);
+    r->checkCount = 0;
+    while (!world.gameOver && world.frameCount < maxSteps) {
+        if (script == SCRIPT_BOT) rrBotInput(&bot, &world, &input);
+        else mashInput(&inputRng, &duck, &input);
+        rrStep(&world, &input);
+
+        chain = (chain ^ rrWorldHash(&world)) * 0x9E3779B97F4A7C15ull;
+        if (world.frameCount % CHECK_TICKS == 0 && r->checkCount < MAX_CHECKS - 1) {
+            r->checks[r->checkCount++] = chain;
+        }
+    }
+    rrBotFree(&bot);
+    if (r->checkCount == 0 || world.frameCount % CHECK_TICKS != 0) r->checks[r->checkCount++] = chain;
+    r->finalTick = world.frameCount;
+    r->score = world.score;
+}
+
+// 生成全部脚本局，返回局数 (runs 为 NULL 时只计数)
+static int runAll(SyncRun* runs, int seeds, int maxSteps, unsigned long long baseSeed) {
+    int n = 0;
+    for (int ch = 0; ch < CHAR_COUNT; ch++) {
+        for (int lv = 0; lv < LEVEL_COUNT; lv++) {
+            for (int g = 1; g <= RR_GRAVITY_LEVELS; g++) {
+                for (int sc = 0; sc < SCRIPT_COUNT; sc++) {
+                    for (int s = 0; s < seeds; s++, n++) {
+                        if (!runs) continue;
+                        unsigned long long seed = baseSeed + (unsigned long long)n * 2654435761u;
+                        snprintf(runs[n].name, sizeof(runs[n].name), "c%d-l%d-g%d-%s-%d", ch, lv, g, scriptNames[sc], s);
+                        runScenario(&runs[n], (CharacterType)ch, (DifficultyLevel)lv, g, sc, seed, NULL, 0, maxSteps);
+                    }
+                }
+            }
+        }
+    }
+
+    // 节拍模式: 间隔不等的拍子循环播放
+    static int beats[BEAT_COUNT];
+    int tick = 60;
+    for (int i = 0; i < BEAT_COUNT; i++) {
+        beats[i] = tick;
+        tick += 30 + (i * 7) % 25;
+    }
+    for (int ch = 0; ch < CHAR_COUNT; ch++, n++) {
+        if (!runs) continue;
+        snprintf(runs[n].name, sizeof(runs[n].name), "c%d-beat", ch);
+        runScenario(&runs[n], (CharacterType)ch, LEVEL_NORMAL, RR_GRAVITY_NORMAL, SCRIPT_BOT,
+                    baseSeed, beats, tick, maxSteps);
+    }
+    return n;
+}
+
+static int writeFile(const char* path, int seeds, int maxSteps, unsigned long long baseSeed) {
+    int n = runAll(NULL, seeds, maxSteps, 0);
+    SyncRun* runs = (SyncRun*)malloc(sizeof(SyncRun) * n);
+    runAll(runs, seeds, maxSteps, baseSeed);
+
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        printf("无法写入: %s\n", path);
+        free(runs);
+        return 1;
+    }
+    fprintf(f, "%s %d %d %d %llu %d\n", SYNC_MAGIC, SYNC_VERSION, seeds, maxSteps, baseSeed, n);
+    long long steps = 0;
+    for (int i = 0; i < n; i++) {
+        fprintf(f, "%s %d %d %d", runs[i].name, runs[i].finalTick, runs[i].score, runs[i].checkCount);
+        for (int k = 0; k < runs[i].checkCount; k++) {
+            fprintf(f, " %016llx", (unsigned long long)runs[i].checks[k]);
+        }
+        fprintf(f, "\n");
+        steps += runs[i].finalTick;
+    }
+    fclose(f);
+    printf("已写入 %d 局, 共 %lld 步: %s\n", n, steps, path);
+    free(runs);
+    return 0;
+}
+
+static int checkFile(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        printf("无法读取: %s\n", path);
+        return 1;
+    }
+    char magic[16];
+    int version, seeds, maxSteps, n;
+    unsigned long long baseSeed;
+    if (fscanf(f, "%15s %d %d %d %llu %d", magic, &version, &seeds, &maxSteps, &baseSeed, &n) != 6 ||
+        strcmp(magic, SYNC_MAGIC) != 0 || version != SYNC_VERSION || n != runAll(NULL, seeds, maxSteps, 0)) {
+        printf("文件格式不对: %s\n", path);
+        fclose(f);
+        return 1;
+    }
+
+    SyncRun* runs = (SyncRun*)malloc(sizeof(SyncRun) * n);
+    runAll(runs, seeds, maxSteps, baseSeed);
+
+    int mismatches = 0;
+    SyncRun expect;
+    for (int i = 0; i < n; i++) {
+        if (fscanf(f, "%63s %d %d %d", expect.name, &expect.finalTick, &expect.score, &expect.checkCount) != 4 ||
+            expect.checkCount > MAX_CHECKS) {
+            printf("文件格式不对: %s\n", path);
+            mismatches++;
+            break;
+        }
+        for (int k = 0; k < expect.checkCount; k++) {
+            unsigned long long v = 0;
+            if (fscanf(f, "%llx", &v) != 1) v = 0;
+            expect.checks[k] = v;
+        }
+
+        const SyncRun* got = &runs[i];
+        int count = (got->checkCount < expect.checkCount) ? got->checkCount : expect.checkCount;
+        int k = 0;
+        while (k < count && got->checks[k] == expect.checks[k]) k++;
+        if (k == count && got->checkCount == expect.checkCount &&
+            got->finalTick == expect.finalTick && got->score == expect.score) {
+            continue;
+        }
+        if (mismatches == 0) {
+            printf("第一个分歧: %s, 在第 %d..%d 步之间\n", expect.name, k * CHECK_TICKS,
+                   (k + 1) * CHECK_TICKS < expect.finalTick ? (k + 1) * CHECK_TICKS : expect.finalTick);
+        }
+        printf("  不一致: %s (记录 %d 步 %d 分, 本机 %d 步 %d 分)\n",
+               expect.name, expect.finalTick, expect.score, got->finalTick, got->score);
+        mismatches++;
+    }
+    fclose(f);
+    free(runs);
+
+    printf("检查 %d 局: %s\n", n, mismatches ? "有分歧!" : "全部一致");
+    return mismatches ? 2 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && strcmp(argv[1], "write") == 0) {
+        int seeds = (argc > 3) ? atoi(argv[3]) : 1;
+        int maxSteps = (argc > 4) ? atoi(argv[4]) : 36000;
+        unsigned long long baseSeed = (argc > 5) ? strtoull(argv[5], NULL, 10) : 1;
+        if (seeds > 0 && maxSteps > 0 && maxSteps < CHECK_TICKS * (MAX_CHECKS - 1)) {
+            return writeFile(argv[2], seeds, maxSteps, baseSeed);
+        }
+    } else if (argc >= 3 && strcmp(argv[1], "check") == 0) {
+        return checkFile(argv[2]);
+    }
+    printf("用法: rr_sync_tool write 结果文件 [每组种子数] [每局最大步数] [种子]\n");
+    printf("      rr_sync_tool check 结果文件\n");
+    return 1;
+}
@@ -0,0 +1,460 @@
+/*
+ * 文件名: rr_tile.cpp
+ * 描述: 分块并行的 CPU 光栅化
+ *       分块: 先数每块有几条命令，前缀和排出每块在表里的起点，再填一遍 (表从内存池里切)
+ *       光栅化: 每个线程拿 target 的浅拷贝 (rrSoftAttach)，块与块不相交，写同一块帧缓冲不需要加锁
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "rr_tile.h"
+
+// --- 图元类型 ---
+enum {
+    CMD_CLEAR,
+    CMD_SOLID_RECT,
+    CMD_RECT,
+    CMD_SOLID_ELLIPSE,
+    CMD_ELLIPSE,
+    CMD_SOLID_CIRCLE,
+    CMD_POLYGON,
+    CMD_LINE,
+    CMD_TEXT,
+    CMD_LAYER
+};
+
+struct RRTileCmd {
+    RRTileCmd* next;
+    int op;
+    int a, b, c, d;
+    RRColor color;
+    int textHeight;
+    int count;                  // 顶点数
+    void* layer;
+    const void* data;           // 文字 / 顶点 (在内存池里)
+    RRRect clip;                // 录制时的裁剪框
+    RRRect bounds;              // 可能写到的像素 (已和 clip 求交)
+};
+
+// 一次分块的结果，所有线程只读
+typedef struct {
+    RRSoftTarget* target;
+    RRTileCmd** cmds;           // 录制顺序
+    int* start;                 // 第 i 块的命令下标在 refs[start[i] .. start[i + 1])
+    int* refs;
+    int* order;                 // 有命令的块，按命令数从多到少
+    int tileCount;
+} TileJob;
+
+// --- 常驻线程 ---
+struct RRTilePool {
+    std::vector<std::thread> workers;
+    std::mutex lock;
+    std::condition_variable wake;       // 有新任务 / 要退出
+    std::condition_variable finished;   // 所有线程都画完了
+    const TileJob* job;
+    int generation;                     // 每发一次任务加 1
+    int running;                        // 还没画完的线程数
+    int quit;
+    std::atomic<int> next;              // 下一个要领的块
+    std::vector<long long> written;     // 每个线程写的像素数 (线程 0 = 调用线程)
+};
+
+// 一条命令交给软件后端画，只写 clip 以内
+static void drawCmd(const RRRenderOps* ops, RRSoftTarget* view, const RRTileCmd* cmd, RRRect clip) {
+    ops->setClip(view, clip.left, clip.top, clip.right, clip.bottom);
+    switch (cmd->op) {
+        case CMD_CLEAR:
+            ops->clear(view, cmd->color);
+            break;
+        case CMD_SOLID_RECT:
+            ops->solidRect(view, cmd->a, cmd->b, cmd->c, cmd->d, cmd->color);
+            break;
+        case CMD_RECT:
+            ops->rect(view, cmd->a, cmd->b, cmd->c, cmd->d, cmd->color);
+            break;
+        case CMD_SOLID_ELLIPSE:
+            ops->solidEllipse(view, cmd->a, cmd->b, cmd->c, cmd->d, cmd->color);
+            break;
+        case CMD_ELLIPSE:
+            ops->ellipse(view, cmd->a, cmd->b, cmd->c, cmd->d, cmd->color);
+            break;
+        case CMD_SOLID_CIRCLE:
+            ops->solidCircle(view, cmd->a, cmd->b, cmd->c, cmd->color);
+            break;
+        case CMD_POLYGON:
+            ops->solidPolygon(view, (const RRPoint*)cmd->data, cmd->count, cmd->color);
+            break;
+        case CMD_LINE:
+            ops->line(view, cmd->a, cmd->b, cmd->c, cmd->d, cmd->color);
+            break;
+        case CMD_TEXT:
+            ops->text(view, cmd->a, cmd->b, (const char*)cmd->data, cmd->textHeight, cmd->color);
+            break;
+        case CMD_LAYER:
+            ops->drawLayer(view, cmd->layer, cmd->a, cmd->b, cmd->c, cmd->d);
+            break;
+    }
+}
+
+// 画一块: 逐条命令把裁剪框收到块里再画
+static void drawTile(const TileJob* job, int tile, RRRenderer* r, RRSoftTarget* view) {
+    RRRect box = rrRectMake(0, tile * RR_TILE_ROWS, job->target->width - 1, tile * RR_TILE_ROWS + RR_TILE_ROWS - 1);
+    for (int k = job->start[tile]; k < job->start[tile + 1]; k++) {
+        const RRTileCmd* cmd = job->cmds[job->refs[k]];
+        drawCmd(r->ops, view, cmd, rrRectIntersect(cmd->clip, box));
+    }
+}
+
+// 从计数器领块直到领完，返回写了多少像素
+static long long drawTiles(const TileJob* job, std::atomic<int>* next) {
+    RRSoftTarget view = *job->target;
+    RRRenderer r;
+    view.pixelsWritten = 0;
+    rrSoftAttach(&r, &view);
+    for (;;) {
+        int i = next->fetch_add(1, std::memory_order_relaxed);
+        if (i >= job->tileCount) break;
+        drawTile(job, job->order[i], &r, &view);
+    }
+    return view.pixelsWritten;
+}
+
+static void poolWorker(RRTilePool* p, int index) {
+    int seen = 0;
+    for (;;) {
+        const TileJob* job;
+        {
+            std::unique_lock<std::mutex> guard(p->lock);
+            while (!p->quit && p->generation == seen) p->wake.wait(guard);
+            if (p->quit) return;
+            seen = p->generation;
+            job = p->job;
+        }
+        long long written = drawTiles(job, &p->next);
+        std::lock_guard<std::mutex> guard(p->lock);
+        p->written[index] = written;
+        if (--p->running == 0) p->finished.notify_one();
+    }
+}
+
+// 调用线程也参与，返回时所有块都画完了
+static long long runJob(RRTileRaster* t, const TileJob* job) {
+    RRTilePool* p = t->pool;
+    if (p == NULL || job->tileCount < 2) {
+        std::atomic<int> next(0);
+        return drawTiles(job, &next);
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(p->lock);
+        p->job = job;
+        p->next.store(0);
+        p->running = (int)p->workers.size();
+        p->generation++;
+    }
+    p->wake.notify_all();
+    long long written = drawTiles(job, &p->next);
+
+    std::unique_lock<std::mutex> guard(p->lock);
+    while (p->running > 0) p->finished.wait(guard);
+    for (size_t i = 0; i < p->workers.size(); i++) written += p->written[i];
+    return written;
+}
+
+// 分块表分配不到内存时: 在调用线程上按录制顺序整条画 (裁剪是精确的，像素与分块画相同)
+// 画完清空待画的命令，它们指向的内存池在 present 时归零
+static void flushSerial(RRTileRaster* t) {
+    RRSoftTarget view = *t->target;
+    RRRenderer r;
+    view.pixelsWritten = 0;
+    rrSoftAttach(&r, &view);
+    for (const RRTileCmd* cmd = t->first; cmd != NULL; cmd = cmd->next) {
+        if (!rrRectEmpty(cmd->bounds)) drawCmd(r.ops, &view, cmd, cmd->clip);
+    }
+    t->target->pixelsWritten += view.pixelsWritten;
+    t->cmds += t->pending;
+    t->first = t->last = NULL;
+    t->pending = 0;
+}
+
+// --- 分块 ---
+static void flush(RRTileRaster* t) {
+    if (t->pending == 0) return;
+    RRSoftTarget* target = t->target;
+    int tiles = (target->height + RR_TILE_ROWS - 1) / RR_TILE_ROWS;
+
+    TileJob job;
+    job.target = target;
+    job.cmds = (RRTileCmd**)rrArenaAlloc(&t->arena, sizeof(RRTileCmd*) * t->pending);
+    job.start = (int*)rrArenaAlloc(&t->arena, sizeof(int) * (tiles + 1));
+    job.order = (int*)rrArenaAlloc(&t->arena, sizeof(int) * tiles);
+    if (job.cmds == NULL || job.start == NULL || job.order == NULL) {
+        flushSerial(t);
+        return;
+    }
+
+    // 第一遍: 每块几条命令
+    memset(job.start, 0, sizeof(int) * (tiles + 1));
+    int n = 0, refs = 0;
+    for (RRTileCmd* cmd = t->first; cmd != NULL; cmd = cmd->next) {
+        job.cmds[n++] = cmd;
+        if (rrRectEmpty(cmd->bounds)) continue;
+        for (int i = cmd->bounds.top / RR_TILE_ROWS; i <= cmd->bounds.bottom / RR_TILE_ROWS; i++) {
+            job.start[i + 1]++;
+            refs++;
+        }
+    }
+    for (int i = 0; i < tiles; i++) job.start[i + 1] += job.start[i];
+
+    // 第二遍: 按录制顺序填进各块
+    job.refs = (int*)rrArenaAlloc(&t->arena, sizeof(int) * (refs > 0 ? refs : 1));
+    int* fill = (int*)rrArenaAlloc(&t->arena, sizeof(int) * tiles);
+    if (job.refs == NULL || fill == NULL) {
+        flushSerial(t);
+        return;
+    }
+    memcpy(fill, job.start, sizeof(int) * tiles);
+    for (int k = 0; k < n; k++) {
+        const RRTileCmd* cmd = job.cmds[k];
+        if (rrRectEmpty(cmd->bounds)) continue;
+        for (int i = cmd->bounds.top / RR_TILE_ROWS; i <= cmd->bounds.bottom / RR_TILE_ROWS; i++) {
+            job.refs[fill[i]++] = k;
+        }
+    }
+
+    // 命令多的块先领，最后剩下的都是小块，线程差不多同时画完
+    job.tileCount = 0;
+    for (int i = 0; i < tiles; i++) {
+        int size = job.start[i + 1] - job.start[i];
+        if (size == 0) continue;
+        int j = job.tileCount++;
+        while (j > 0 && job.start[job.order[j - 1] + 1] - job.start[job.order[j - 1]] < size) {
+            job.order[j] = job.order[j - 1];
+            j--;
+        }
+        job.order[j] = i;
+    }
+
+    target->pixelsWritten += runJob(t, &job);
+    t->cmds += n;
+    t->tiles += job.tileCount;
+    t->refs += refs;
+    t->first = t->last = NULL;
+    t->pending = 0;
+}
+
+// --- 录制 ---
+static RRTileCmd* pushCmd(RRTileRaster* t, int op, RRColor color, RRRect bounds) {
+    RRTileCmd* cmd = (RRTileCmd*)rrArenaAlloc(&t->arena, sizeof(RRTileCmd));
+    if (cmd == NULL) return NULL;
+    memset(cmd, 0, sizeof(RRTileCmd));
+    cmd->op = op;
+    cmd->color = color;
+    cmd->clip = t->clip;
+    cmd->bounds = rrRectIntersect(bounds, t->clip);
+    if (t->last != NULL) {
+        t->last->next = cmd;
+    } else {
+        t->first = cmd;
+    }
+    t->last = cmd;
+    t->pending++;
+    return cmd;
+}
+
+static void recordBox(RRTileRaster* t, int op, int left, int top, int right, int bottom, RRColor color) {
+    RRTileCmd* cmd = pushCmd(t, op, color, rrRectMake(left, top, right, bottom));
+    if (cmd == NULL) return;
+    cmd->a = left;
+    cmd->b = top;
+    cmd->c = right;
+    cmd->d = bottom;
+}
+
+static void tileClear(void* impl, RRColor color) {
+    RRTileRaster* t = (RRTileRaster*)impl;
+    pushCmd(t, CMD_CLEAR, color, t->clip);
+}
+
+static void tileSolidRect(void* impl, int left, int top, int right, int bottom, RRColor color) {
+    recordBox((RRTileRaster*)impl, CMD_SOLID_RECT, left, top, right, bottom, color);
+}
+
+static void tileRect(void* impl, int left, int top, int right, int bottom, RRColor color) {
+    recordBox((RRTileRaster*)impl, CMD_RECT, left, top, right, bottom, color);
+}
+
+static void tileSolidEllipse(void* impl, int left, int top, int right, int bottom, RRColor color) {
+    recordBox((RRTileRaster*)impl, CMD_SOLID_ELLIPSE, left, top, right, bottom, color);
+}
+
+static void tileEllipse(void* impl, int left, int top, int right, int bottom, RRColor color) {
+    recordBox((RRTileRaster*)impl, CMD_ELLIPSE, left, top, right, bottom, color);
+}
+
+static void tileSolidCircle(void* impl, int x, int y, int radius, RRColor color) {
+    RRTileRaster* t = (RRTileRaster*)impl;
+    RRTileCmd* cmd = pushCmd(t, CMD_SOLID_CIRCLE, color, rrRectMake(x - radius, y - radius, x + radius, y + radius));
+    if (cmd == NULL) return;
+    cmd->a = x;
+    cmd->b = y;
+    cmd->c = radius;
+}
+
+static void tileSolidPolygon(void* impl, const RRPoint* points, int count, RRColor color) {
+    RRTileRaster* t = (RRTileRaster*)impl;
+    if (count <= 0) return;
+    RRPoint* copy = (RRPoint*)rrArenaAlloc(&t->arena, sizeof(RRPoint) * count);
+    if (copy == NULL) return;
+    memcpy(copy, points, sizeof(RRPoint) * count);
+    RRRect bounds = rrRectMake(points[0].x, points[0].y, points[0].x, points[0].y);
+    for (int i = 1; i < count; i++) {
+        bounds = rrRectUnion(bounds, rrRectMake(points[i].x, points[i].y, points[i].x, points[i].y));
+    }
+    RRTileCmd* cmd = pushCmd(t, CMD_POLYGON, color, bounds);
+    if (cmd == NULL) return;
+    cmd->count = count;
+    cmd->data = copy;
+}
+
+static void tileLine(void* impl, int x1, int y1, int x2, int y2, RRColor color) {
+    recordBox((RRTileRaster*)impl, CMD_LINE, x1, y1, x2, y2, color);
+}
+
+static int tileTextWidth(void* impl, const char* text, int height) {
+    RRTileRaster* t = (RRTileRaster*)impl;
+    return t->direct.ops->textWidth(t->target, text, height);
+}
+
+static void tileText(void* impl, int x, int y, const char* text, int height, RRColor color) {
+    RRTileRaster* t = (RRTileRaster*)impl;
+    size_t size = strlen(text) + 1;
+    char* copy = (char*)rrArenaAlloc(&t->arena, size);
+    if (copy == NULL) return;
+    memcpy(copy, text, size);
+    // 软件后端的占位字形在小字号下格子至少 1 像素，可能超出字框，外接框多留一点
+    int width = tileTextWidth(impl, text, height);
+    int pad = (height < 16) ? 16 : 0;
+    RRTileCmd* cmd = pushCmd(t, CMD_TEXT, color, rrRectMake(x, y, x + width - 1 + pad, y + height - 1 + pad));
+    if (cmd == NULL) return;
+    cmd->a = x;
+    cmd->b = y;
+    cmd->textHeight = height;
+    cmd->data = copy;
+}
+
+static void tileDrawLayer(void* impl, void* layer, int x, int y, int width, int height) {
+    RRTileRaster* t = (RRTileRaster*)impl;
+    RRTileCmd* cmd = pushCmd(t, CMD_LAYER, 0, rrRectMake(x, y, x + width - 1, y + height - 1));
+    if (cmd == NULL) return;
+    cmd->a = x;
+    cmd->b = y;
+    cmd->c = width;
+    cmd->d = height;
+    cmd->layer = layer;
+}
+
+// 裁剪框只记下来，每条命令带着它录制时的裁剪框
+static void tileSetClip(void* impl, int left, int top, int right, int bottom) {
+    RRTileRaster* t = (RRTileRaster*)impl;
+    RRSoftTarget* target = t->target;
+    t->clip = rrRectIntersect(rrRectMake(left, top, right, bottom),
+                              rrRectMake(0, 0, target->width - 1, target->height - 1));
+}
+
+// --- 图层: 直接交给软件后端 (切换前先把之前的命令画完) ---
+static void* tileCreateLayer(void* impl, int width, int height) {
+    RRTileRaster* t = (RRTileRaster*)impl;
+    return t->direct.ops->createLayer(t->target, width, height);
+}
+
+static void tileFreeLayer(void* impl, void* layer) {
+    RRTileRaster* t = (RRTileRaster*)impl;
+    t->direct.ops->freeLayer(t->target, layer);
+}
+
+static void tileBeginLayer(void* impl, void* layer) {
+    RRTileRaster* t = (RRTileRaster*)impl;
+    flush(t);
+    t->direct.ops->beginLayer(t->target, layer);
+    t->clip = rrRectMake(0, 0, t->target->width - 1, t->target->height - 1);
+}
+
+static void tilePresent(void* impl) {
+    RRTileRaster* t = (RRTileRaster*)impl;
+    flush(t);
+    t->direct.ops->present(t->target);
+
+    t->lastCmds = t->cmds;
+    t->lastTiles = t->tiles;
+    t->lastRefs = t->refs;
+    t->cmds = t->tiles = t->refs = 0;
+    rrArenaReset(&t->arena);
+}
+
+static const RRRenderOps tileOps = {
+    tileClear,
+    tileSolidRect,
+    tileRect,
+    tileSolidEllipse,
+    tileEllipse,
+    tileSolidCircle,
+    tileSolidPolygon,
+    tileLine,
+    tileText,
+    tileTextWidth,
+    tileSetClip,
+    tileCreateLayer,
+    tileFreeLayer,
+    tileBeginLayer,
+    tileDrawLayer,
+    tilePresent
+};
+
+int rrTileInit(RRRenderer* r, RRTileRaster* t, RRSoftTarget* target, int threads) {
+    memset(t, 0, sizeof(RRTileRaster));
+    t->target = target;
+    rrSoftAttach(&t->direct, target);
+    rrArenaInit(&t->arena, 64 * 1024);
+    t->clip = rrRectMake(target->clipLeft, target->clipTop, target->clipRight, target->clipBottom);
+
+    if (threads <= 0) threads = (int)std::thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+    t->threads = threads;
+    if (threads > 1) {
+        RRTilePool* p = new RRTilePool;
+        p->job = NULL;
+        p->generation = 0;
+        p->running = 0;
+        p->quit = 0;
+        p->next.store(0);
+        p->written.assign(threads - 1, 0);
+        for (int i = 0; i < threads - 1; i++) {
+            p->workers.push_back(std::thread(poolWorker, p, i));
+        }
+        t->pool = p;
+    }
+    rrRendererInit(r, &tileOps, t, target->width, target->height);
+    return t->arena.base != NULL;
+}
+
+void rrTileFree(RRTileRaster* t) {
+    RRTilePool* p = t->pool;
+    if (p != NULL) {
+        {
+            std::lock_guard<std::mutex> guard(p->lock);
+            p->quit = 1;
+        }
+        p->wake.notify_all();
+        for (size_t i = 0; i < p->workers.size(); i++) p->workers[i].join();
+        delete p;
+    }
+    rrArenaFree(&t->arena);
+    memset(t, 0, sizeof(RRTileRaster));
+}
@@ -0,0 +1,44 @@
+/*
+ * 文件名: rr_tile.h
+ * 描述: 分块并行的 CPU 光栅化: 本身是一个绘制后端，图元先记下来 (内存池分配)，
+ *       到图层切换 / present 时按外接框分进 RR_TILE_ROWS 行高的整行条带，几个线程各领一块画
+ *       每块里按录制顺序画，裁剪框 = 图元当时的裁剪框 ∩ 块，
+ *       软件后端只在 span 一处裁剪，所以结果和单线程直接画逐位相同
+ *       线程常驻，每次分块时唤醒；块按图元数从多到少排好，线程从同一个原子计数器领 (和 rr_balance 一样)
+ */
+#ifndef RR_TILE_H
+#define RR_TILE_H
+
+#include "rr_arena.h"
+#include "rr_render.h"
+#include "rr_render_soft.h"
+
+// 块取整行宽: 方块会把每条 span 和图层的每行 memcpy 切成几段，单线程时实测慢一倍多
+#define RR_TILE_ROWS 16
+
+typedef struct RRTileCmd RRTileCmd;
+typedef struct RRTilePool RRTilePool;
+
+typedef struct {
+    RRSoftTarget* target;
+    RRRenderer direct;          // 直接画到 target 上 (图层的建立 / 切换)
+    RRArena arena;              // 本帧的命令和分块表，present 后整体归零
+    RRTileCmd* first;           // 还没画的命令 (录制顺序)
+    RRTileCmd* last;
+    int pending;
+    RRRect clip;                // 当前裁剪框
+    int threads;
+    RRTilePool* pool;           // threads > 1 时的常驻线程
+
+    // 统计: 本帧累计 / 上一帧
+    int cmds, tiles, refs;
+    int lastCmds;
+    int lastTiles;              // 有图元的块数
+    int lastRefs;               // 图元进块的总次数 (跨块的图元每块算一次)
+} RRTileRaster;
+
+// r 接到分块光栅化上，画到 target；threads <= 0 = CPU 核数，成功返回 1
+int rrTileInit(RRRenderer* r, RRTileRaster* t, RRSoftTarget* target, int threads);
+void rrTileFree(RRTileRaster* t);
+
+#endif